@@ -14,6 +14,50 @@
 #include <thread>
 #include <future>
 #include <array>
+#include <functional>
+#include <condition_variable>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <algorithm>
+#include <span>
+#include <spanstream>
+#include <cstddef>
+#include <cerrno>
+#include <cmath>
+#include <iomanip>
+#include <optional>
+#include <unordered_map>
+#include <bit>
+#include <charconv>
+#include <cstdlib>
+#ifndef _WIN32
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <poll.h>
+  #include <spawn.h>
+  #include <signal.h>
+  #include <sys/wait.h>
+  #include <sys/socket.h>
+  #include <netdb.h>
+  #include <netinet/in.h>
+  #include <netinet/tcp.h>
+#endif
+#ifdef __linux__
+  #include <sys/sendfile.h>
+  #include <sys/syscall.h>
+  #include <sys/ioctl.h>
+  #include <linux/perf_event.h>
+  #include <sys/inotify.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+#endif
+#if defined(__SSE2__) || defined(__AVX2__)
+  #include <immintrin.h>
+#endif
 
 
 #pragma once
@@ -81,26 +125,316 @@ namespace cslib {
 
 
 
+  #ifndef _WIN32
+  struct ProcessResult {
+    int exitCode = -1; // Exit code, 128 + signal if killed
+    int rawStatus = -1; // As reported by waitpid
+    str_t out; // Only filled without an onStdout callback
+    str_t err; // Only filled without an onStderr callback
+    bool timedOut = false;
+  };
+  class Process { public:
+    /*
+      Child process started through posix_spawn with
+      stdout (and stderr) on pipes that are drained with
+      poll() in large chunks. Set the public members
+      before calling run() (or run_batch()).
+      Note:
+        Arguments are passed as they are, without any
+        shell in between, unless Process::shell is used.
+      Example:
+        cslib::Process grep({"grep", "-rn", "TODO", "src"});
+        grep.timeout = std::chrono::seconds(5);
+        grep.onStdout = [](strv_t chunk) { std::cout << chunk; };
+        cslib::ProcessResult result = grep.run();
+    */
+    std::vector<str_t> argv;
+    std::function<void(strv_t)> onStdout; // Streams output instead of collecting it
+    std::function<void(strv_t)> onStderr;
+    bool captureStderr = true; // Otherwise the child shares our stderr
+    std::chrono::milliseconds timeout = std::chrono::milliseconds(0); // 0 = none, killed with SIGKILL after
+    ProcessResult result;
+    pid_t pid = -1;
+    int outFd = -1;
+    int errFd = -1;
+    int exitFd = -1; // pidfd on Linux, readable once the child exits
+    std::chrono::steady_clock::time_point deadline;
+
+
+    Process(std::vector<str_t> argv_) : argv(std::move(argv_)) {
+      if (argv.empty())
+        throw std::invalid_argument("Process needs at least the program to run");
+    }
+    static Process shell(strv_t command) {
+      // Important note: As injection prone as sh_call
+      return Process({"/bin/sh", "-c", str_t(command)});
+    }
+    ~Process() noexcept {
+      if (outFd != -1)
+        ::close(outFd);
+      if (errFd != -1)
+        ::close(errFd);
+      if (exitFd != -1)
+        ::close(exitFd);
+      if (pid > 0) { // Never waited for
+        ::kill(timeout.count() > 0 ? -pid : pid, SIGKILL);
+        ::waitpid(pid, nullptr, 0);
+      }
+    }
+    Process(Process&& other) noexcept :
+      argv(std::move(other.argv)),
+      onStdout(std::move(other.onStdout)),
+      onStderr(std::move(other.onStderr)),
+      captureStderr(other.captureStderr),
+      timeout(other.timeout),
+      result(std::move(other.result)),
+      pid(std::exchange(other.pid, -1)),
+      outFd(std::exchange(other.outFd, -1)),
+      errFd(std::exchange(other.errFd, -1)),
+      exitFd(std::exchange(other.exitFd, -1)),
+      deadline(other.deadline) {}
+    Process(const Process&) = delete;
+    Process& operator=(const Process&) = delete;
+    Process& operator=(Process&&) = delete;
+
+
+    ProcessResult run();
+    bool running() const noexcept { return pid > 0; }
+
+
+    void start() noexcept {
+      /*
+        Spawn the child. Failing to do so is reported
+        like the shell would (exit code 127).
+      */
+      result = ProcessResult{};
+      std::array<int, 2> outPipe = {-1, -1}, errPipe = {-1, -1};
+      const auto fail = [&](strv_t what) {
+        for (int fd : {outPipe.at(0), outPipe.at(1), errPipe.at(0), errPipe.at(1)})
+          if (fd != -1)
+            ::close(fd);
+        result.exitCode = 127;
+        result.rawStatus = 127 << 8;
+        result.err = str_t(what) + ": " + std::strerror(errno);
+      };
+      if (::pipe2(outPipe.data(), O_CLOEXEC) == -1 || (captureStderr && ::pipe2(errPipe.data(), O_CLOEXEC) == -1))
+        return fail("Failed to create pipes");
+      posix_spawn_file_actions_t actions;
+      posix_spawnattr_t attributes;
+      ::posix_spawn_file_actions_init(&actions);
+      ::posix_spawnattr_init(&attributes);
+      ::posix_spawn_file_actions_adddup2(&actions, outPipe.at(1), STDOUT_FILENO);
+      if (captureStderr)
+        ::posix_spawn_file_actions_adddup2(&actions, errPipe.at(1), STDERR_FILENO);
+      if (timeout.count() > 0) { // Own process group so a timeout kills grandchildren too
+        ::posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+        ::posix_spawnattr_setpgroup(&attributes, 0);
+      }
+      std::vector<char*> args;
+      for (str_t& arg : argv)
+        args.push_back(arg.data());
+      args.push_back(nullptr);
+      const int spawned = ::posix_spawnp(&pid, args.front(), &actions, &attributes, args.data(), environ);
+      ::posix_spawn_file_actions_destroy(&actions);
+      ::posix_spawnattr_destroy(&attributes);
+      if (spawned != 0) {
+        pid = -1;
+        errno = spawned;
+        return fail("Failed to spawn '" + argv.front() + "'");
+      }
+      ::close(outPipe.at(1));
+      outFd = outPipe.at(0);
+      ::fcntl(outFd, F_SETFL, O_NONBLOCK);
+      if (captureStderr) {
+        ::close(errPipe.at(1));
+        errFd = errPipe.at(0);
+        ::fcntl(errFd, F_SETFL, O_NONBLOCK);
+      }
+      #if defined(__linux__) && defined(SYS_pidfd_open)
+        exitFd = int(::syscall(SYS_pidfd_open, pid, 0)); // -1 before Linux 5.3, run_batch copes
+      #endif
+      deadline = std::chrono::steady_clock::now() + timeout;
+    }
+    void drain(int& fd, std::vector<char>& buffer) {
+      // Read whatever is there, close `fd` on EOF
+      while (true) {
+        const ssize_t got = ::read(fd, buffer.data(), buffer.size());
+        if (got > 0) {
+          const strv_t chunk(buffer.data(), size_t(got));
+          const bool isOut = fd == outFd;
+          if (const std::function<void(strv_t)>& callback = isOut ? onStdout : onStderr)
+            callback(chunk);
+          else
+            (isOut ? result.out : result.err) += chunk;
+          continue;
+        }
+        if (got < 0 && errno == EINTR)
+          continue;
+        if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+          return;
+        ::close(fd); // EOF or error
+        fd = -1;
+        return;
+      }
+    }
+    bool reap(bool block = false) noexcept {
+      // True once the child is gone (and result is final)
+      int status = 0;
+      pid_t done = 0;
+      do
+        done = ::waitpid(pid, &status, block ? 0 : WNOHANG);
+      while (done == -1 && errno == EINTR);
+      if (done == 0)
+        return false;
+      if (exitFd != -1) {
+        ::close(exitFd);
+        exitFd = -1;
+      }
+      if (done == pid) {
+        result.rawStatus = status;
+        result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : WIFSIGNALED(status) ? 128 + WTERMSIG(status) : -1;
+      }
+      pid = -1;
+      return true;
+    }
+    void kill() noexcept {
+      // Timed out: the group goes, no point in waiting for its pipes
+      ::kill(-pid, SIGKILL);
+      result.timedOut = true;
+      for (int* fd : {&outFd, &errFd})
+        if (*fd != -1) {
+          ::close(*fd);
+          *fd = -1;
+        }
+    }
+  };
+
+
+
+  void run_batch(std::span<Process* const> processes, size_t maxConcurrent = std::thread::hardware_concurrency()) {
+    /*
+      Run all `processes` with at most `maxConcurrent`
+      of them alive at a time, driven by one poll()
+      loop on the calling thread. Results end up in
+      every process' `result`.
+      Example:
+        std::vector<cslib::Process> jobs;
+        for (str_t file : files)
+          jobs.emplace_back(std::vector<str_t>{"gzip", "-k", file});
+        cslib::run_batch(jobs, 8);
+    */
+    if (maxConcurrent == 0)
+      maxConcurrent = 1;
+    std::vector<char> buffer(size_t(64 * 1024)); // Pipe capacity on Linux
+    std::vector<Process*> running;
+    std::vector<pollfd> polled;
+    size_t next = 0;
+    while (next < processes.size() || !running.empty()) {
+      while (running.size() < maxConcurrent && next < processes.size()) {
+        Process& process = *processes[next++];
+        process.start();
+        if (process.running())
+          running.push_back(&process);
+      }
+      if (running.empty())
+        continue; // Nothing could be started
+
+      polled.clear();
+      int waitMs = -1;
+      Process* unwatched = nullptr; // Pipes closed and no pidfd to tell when it exits
+      const auto now = std::chrono::steady_clock::now();
+      for (Process* process : running) {
+        for (int fd : {process->outFd, process->errFd})
+          if (fd != -1)
+            polled.push_back(pollfd{fd, POLLIN, 0});
+        if (process->outFd == -1 && process->errFd == -1) {
+          if (process->exitFd != -1)
+            polled.push_back(pollfd{process->exitFd, POLLIN, 0});
+          else
+            unwatched = process;
+        }
+        if (process->timeout.count() > 0 && !process->result.timedOut) {
+          const int left = int(std::max<int64_t>(0, std::chrono::ceil<std::chrono::milliseconds>(process->deadline - now).count()));
+          waitMs = waitMs == -1 ? left : std::min(waitMs, left);
+        }
+      }
+      if (unwatched != nullptr) {
+        if (polled.empty() && waitMs == -1) { // Nothing else can happen meanwhile
+          unwatched->reap(true);
+          std::erase(running, unwatched);
+          continue;
+        }
+        waitMs = waitMs == -1 ? 10 : std::min(waitMs, 10);
+      }
+      if (::poll(polled.data(), polled.size(), waitMs) == -1 && errno != EINTR)
+        throw std::runtime_error(str_t("poll failed in run_batch: ") + std::strerror(errno));
+
+      for (Process* process : running) {
+        for (int* fd : {&process->outFd, &process->errFd})
+          if (*fd != -1 && std::ranges::any_of(polled, [fd](const pollfd& p) { return p.fd == *fd && p.revents != 0; }))
+            process->drain(*fd, buffer);
+        if (process->timeout.count() > 0 && process->pid > 0 && std::chrono::steady_clock::now() >= process->deadline && !process->result.timedOut)
+          process->kill();
+      }
+      std::erase_if(running, [](Process* process) {
+        return process->outFd == -1 && process->errFd == -1 && process->reap();
+      });
+    }
+  }
+  void run_batch(std::vector<Process>& processes, size_t maxConcurrent = std::thread::hardware_concurrency()) {
+    std::vector<Process*> pointers;
+    pointers.reserve(processes.size());
+    for (Process& process : processes)
+      pointers.push_back(&process);
+    run_batch(pointers, maxConcurrent);
+  }
+  ProcessResult Process::run() {
+    // Can be called again, every run starts from a fresh result
+    Process* const self = this;
+    run_batch(std::span<Process* const>(&self, 1), 1);
+    return result;
+  }
+  #endif
+
+
+
   std::expected<str_t, int> sh_call(strv_t command) noexcept {
     /*
       Non-blocking system call that returns the
       output of the command. Returns exit code
       upon failure.
+      Note:
+        Compatibility wrapper, see Process for
+        streaming, timeouts, stderr and batches
       Important Note:
         This method is VERY prone to injections
     */
-    std::array<char, 128> buffer = {};
-    str_t result;
-    int exitCode = -1;
-    FILE* pipe = popen(command.data(), "r"); // Windows has macro to allow go without '_' prefix
-    if (!pipe)
-      return std::unexpected(exitCode);
-    while (fgets(buffer.data(), buffer.size(), pipe) != nullptr)
-      result += buffer.data();
-    exitCode = pclose(pipe); // Windows has macro to allow go without '_' prefix
-    if (exitCode != 0)
-      return std::unexpected(exitCode);
-    return result;
+    #ifndef _WIN32
+      try {
+        Process process = Process::shell(command);
+        process.captureStderr = false; // Like popen
+        const ProcessResult result = process.run();
+        if (result.rawStatus != 0)
+          return std::unexpected(result.rawStatus); // Same value pclose would report
+        return result.out;
+      }
+      catch (...) {
+        return std::unexpected(-1);
+      }
+    #else
+      std::array<char, 128> buffer = {};
+      str_t result;
+      int exitCode = -1;
+      FILE* pipe = popen(command.data(), "r"); // Windows has macro to allow go without '_' prefix
+      if (!pipe)
+        return std::unexpected(exitCode);
+      while (fgets(buffer.data(), buffer.size(), pipe) != nullptr)
+        result += buffer.data();
+      exitCode = pclose(pipe); // Windows has macro to allow go without '_' prefix
+      if (exitCode != 0)
+        return std::unexpected(exitCode);
+      return result;
+    #endif
   }
 
 
@@ -204,6 +538,169 @@ namespace cslib {
 
 
 
+  class ThreadPool { public:
+    /*
+      Work-stealing executor. Every worker owns a deque
+      and pops its own tasks from the back while idle
+      workers steal from the front of the others. Tasks
+      submitted from within a worker land in that
+      worker's deque, so nested submissions stay local.
+      Note:
+        Blocking on a pool future from inside a task can
+        deadlock once every worker waits. Use get() to
+        keep working on other tasks while waiting (the
+        parallel_* helpers do that already).
+      Example:
+        cslib::ThreadPool pool(4);
+        std::future<int> answer = pool.submit([] { return 42; });
+        int value = pool.get(answer);
+    */
+    using task_t = std::function<void()>;
+    struct Worker {
+      std::mutex lock;
+      std::deque<task_t> tasks;
+    };
+    std::vector<uptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::mutex sleepLock;
+    std::condition_variable wakeUp;
+    std::atomic<size_t> queued = 0;
+    std::atomic<size_t> nextWorker = 0;
+    std::atomic<bool> stopping = false;
+    static inline thread_local const ThreadPool* currentPool = nullptr;
+    static inline thread_local size_t currentWorker = 0;
+
+
+    explicit ThreadPool(size_t workerCount = std::thread::hardware_concurrency()) {
+      if (workerCount == 0)
+        workerCount = 1; // hardware_concurrency() may be unknown
+      for ([[maybe_unused]] size_t _ = 0; _ < workerCount; ++_)
+        workers.emplace_back(std::make_unique<Worker>());
+      for (size_t i = 0; i < workerCount; ++i)
+        threads.emplace_back([this, i] { work(i); });
+    }
+    ~ThreadPool() noexcept {
+      // Drains all remaining tasks before joining
+      {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+      }
+      wakeUp.notify_all();
+      for (std::thread& thread : threads)
+        thread.join();
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+
+    static ThreadPool& shared(size_t workerCount = 0) {
+      /*
+        Process-wide pool, created on first use.
+        Note:
+          `workerCount` is only honored by the very
+          first call (0 = hardware concurrency)
+      */
+      static ThreadPool pool(workerCount != 0 ? workerCount : std::thread::hardware_concurrency());
+      return pool;
+    }
+    size_t size() const noexcept { return workers.size(); }
+
+
+    template <typename F, typename... Args>
+    requires std::invocable<F, Args...>
+    [[nodiscard]] std::future<std::invoke_result_t<F, Args...>> submit(F&& f, Args&&... args) {
+      /*
+        Schedule `f(args...)`. Arguments are decay-copied
+        just like std::async does.
+      */
+      using result_t = std::invoke_result_t<F, Args...>;
+      auto task = std::make_shared<std::packaged_task<result_t()>>(
+        [f = std::forward<F>(f), ...args = std::forward<Args>(args)]() mutable -> result_t {
+          return std::invoke(std::move(f), std::move(args)...);
+        }
+      );
+      std::future<result_t> result = task->get_future();
+      push([task] { (*task)(); });
+      return result;
+    }
+    void push(task_t task) {
+      const size_t index = currentPool == this ? currentWorker : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+      queued.fetch_add(1); // Before pushing so a woken worker never misses it
+      {
+        std::lock_guard<std::mutex> guard(workers.at(index)->lock);
+        workers.at(index)->tasks.push_back(std::move(task));
+      }
+      { std::lock_guard<std::mutex> guard(sleepLock); } // Don't notify between a worker's check and its wait
+      wakeUp.notify_one();
+    }
+
+
+    bool run_pending_task() {
+      /*
+        Run one queued task on the calling thread.
+        Returns false if there was nothing to do.
+      */
+      task_t task;
+      if (!take(task, currentPool == this ? currentWorker : 0))
+        return false;
+      task();
+      return true;
+    }
+    template <typename T>
+    T get(std::future<T>& future) {
+      /*
+        Like future.get() but keeps running queued tasks
+        while waiting, which makes nested submissions
+        from inside a worker safe.
+      */
+      while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        if (!run_pending_task())
+          std::this_thread::yield();
+      return future.get();
+    }
+
+
+    bool take(task_t& out, size_t home) {
+      // Own tasks LIFO (cache-warm), stolen ones FIFO (oldest and usually biggest)
+      for (size_t offset = 0; offset < workers.size(); ++offset) {
+        Worker& victim = *workers.at((home + offset) % workers.size());
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (victim.tasks.empty())
+          continue;
+        if (offset == 0) {
+          out = std::move(victim.tasks.back());
+          victim.tasks.pop_back();
+        }
+        else {
+          out = std::move(victim.tasks.front());
+          victim.tasks.pop_front();
+        }
+        queued.fetch_sub(1);
+        return true;
+      }
+      return false;
+    }
+    void work(size_t index) {
+      currentPool = this;
+      currentWorker = index;
+      while (true) {
+        task_t task;
+        if (take(task, index)) {
+          task();
+          continue;
+        }
+        std::unique_lock<std::mutex> guard(sleepLock);
+        wakeUp.wait(guard, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0)
+          return;
+      }
+    }
+  };
+
+
+
   std::vector<str_t> parse_cli_args(int argc, const char *const args[]) {
     /*
       Parse command line arguments and return
@@ -269,15 +766,157 @@ namespace cslib {
 
 
 
+  inline const char* find_sequence(const char* begin, const char* end, strv_t needle) noexcept {
+    /*
+      Position of the first `needle` in [begin, end) or
+      `end`. Compares 32 (AVX2) or 16 (SSE2) candidate
+      positions at once by checking the needle's first
+      and last character before doing a full compare.
+    */
+    const size_t length = needle.size();
+    if (length == 0 || size_t(end - begin) < length)
+      return end;
+    const char first = needle.front();
+    const char last = needle.back();
+    const auto matches_middle = [&](const char* at) {
+      return length <= 2 || std::memcmp(at + 1, needle.data() + 1, length - 2) == 0;
+    };
+    const char* at = begin;
+    const char* const stop = end - length + 1; // One past the last possible start
+    #ifdef __AVX2__
+      const __m256i firsts = _mm256_set1_epi8(first);
+      const __m256i lasts = _mm256_set1_epi8(last);
+      for (; stop - at >= 32; at += 32) {
+        const __m256i heads = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(at));
+        const __m256i tails = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(at + length - 1));
+        for (uint32_t hits = uint32_t(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(heads, firsts), _mm256_cmpeq_epi8(tails, lasts)))); hits != 0; hits &= hits - 1)
+          if (matches_middle(at + std::countr_zero(hits)))
+            return at + std::countr_zero(hits);
+      }
+    #endif
+    #ifdef __SSE2__
+      const __m128i firsts16 = _mm_set1_epi8(first);
+      const __m128i lasts16 = _mm_set1_epi8(last);
+      for (; stop - at >= 16; at += 16) {
+        const __m128i heads = _mm_loadu_si128(reinterpret_cast<const __m128i*>(at));
+        const __m128i tails = _mm_loadu_si128(reinterpret_cast<const __m128i*>(at + length - 1));
+        for (uint32_t hits = uint32_t(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(heads, firsts16), _mm_cmpeq_epi8(tails, lasts16)))); hits != 0; hits &= hits - 1)
+          if (matches_middle(at + std::countr_zero(hits)))
+            return at + std::countr_zero(hits);
+      }
+    #endif
+    for (; at < stop; ++at)
+      if (*at == first && at[length - 1] == last && matches_middle(at))
+        return at;
+    return end;
+  }
+
+
+
+  class SplitView : public std::ranges::view_interface<SplitView> { public:
+    /*
+      Lazy, allocation-free version of separate(). The
+      tokens are views into the original text, so it
+      has to outlive them.
+      Example:
+        for (strv_t field : cslib::SplitView("a,b,,c", ","))
+          ... // "a", "b", "", "c"
+    */
+    strv_t text;
+    strv_t delimiter;
+
+
+    class iterator { public:
+      using iterator_concept = std::forward_iterator_tag;
+      using value_type = strv_t;
+      using difference_type = std::ptrdiff_t;
+      const char* tokenBegin = nullptr;
+      const char* tokenEnd = nullptr; // Where the delimiter starts
+      const char* textEnd = nullptr;
+      strv_t delimiter;
+      bool done = true;
+
+      strv_t operator*() const noexcept { return strv_t(tokenBegin, size_t(tokenEnd - tokenBegin)); }
+      iterator& operator++() noexcept {
+        if (tokenEnd == textEnd)
+          done = true;
+        else {
+          tokenBegin = tokenEnd + delimiter.size();
+          tokenEnd = delimiter.empty() ? tokenBegin + 1 : find_sequence(tokenBegin, textEnd, delimiter);
+        }
+        return *this;
+      }
+      iterator operator++(int) noexcept {
+        iterator old = *this;
+        ++*this;
+        return old;
+      }
+      bool operator==(const iterator& other) const noexcept {
+        return done == other.done && (done || tokenBegin == other.tokenBegin);
+      }
+      bool operator==(std::default_sentinel_t) const noexcept { return done; }
+    };
+
+
+    SplitView() = default;
+    SplitView(strv_t text_, strv_t delimiter_ = "") noexcept : text(text_), delimiter(delimiter_) {}
+    iterator begin() const noexcept {
+      iterator it;
+      if (text.empty())
+        return it; // Like std::views::split, nothing at all
+      it.textEnd = text.data() + text.size();
+      it.delimiter = delimiter;
+      it.done = false;
+      it.tokenBegin = text.data();
+      it.tokenEnd = delimiter.empty() ? it.tokenBegin + 1 : find_sequence(it.tokenBegin, it.textEnd, delimiter);
+      return it;
+    }
+    std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+  };
+
+
+
   std::vector<str_t> separate(strv_t strv, strv_t delimiter = "") noexcept {
     std::vector<str_t> tokens;
-    for (std::ranges::subrange<const char*>&& part : strv | std::views::split(delimiter))
-      tokens.emplace_back(part.begin(), part.end());
+    for (strv_t part : SplitView(strv, delimiter))
+      tokens.emplace_back(part);
     return tokens;
   }
 
 
 
+  inline constexpr bool glob_match(strv_t pattern, strv_t text) noexcept {
+    /*
+      Shell-like wildcard matching where '*' matches
+      any amount of characters and '?' exactly one.
+      Example:
+        cslib::glob_match("*.h++", "cslib.h++"); // true
+    */
+    size_t p = 0, t = 0;
+    size_t starAt = strv_t::npos, resumeAt = 0; // Last '*' and where its match would continue
+    while (t < text.size()) {
+      if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+        ++p;
+        ++t;
+      }
+      else if (p < pattern.size() && pattern[p] == '*') {
+        starAt = p++;
+        resumeAt = t;
+      }
+      else if (starAt != strv_t::npos) { // Let the last '*' swallow one more character
+        p = starAt + 1;
+        t = ++resumeAt;
+      }
+      else
+        return false;
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+      ++p;
+    return p == pattern.size();
+  }
+
+
+
   int roll_dice(int min, int max) noexcept {
     /*
       Minimum and maximum value and returns a random
@@ -353,27 +992,189 @@ namespace cslib {
     inStream.exceptions(std::ios::failbit | std::ios::badbit);
     return std::vector<char>{std::istreambuf_iterator<char>(inStream), std::istreambuf_iterator<char>()};
   }
-  void do_io(std::istream& inStream, std::ostream& outStream) {
-    std::vector<char> data = read_data(inStream);
+  MACRO IO_CHUNK_SIZE = size_t(256 * 1024);
+  void do_io(std::istream& inStream, std::ostream& outStream, size_t chunkSize = IO_CHUNK_SIZE, const std::function<void(size_t)>& onProgress = {}) {
+    /*
+      Stream `inStream` into `outStream` chunk by chunk.
+      Peak memory is two chunks no matter how big the
+      input is; the next chunk is read on the shared
+      pool while the current one is being written.
+      `onProgress` receives the total bytes written
+      so far after every chunk.
+      Example:
+        cslib::do_io(in, out, 1 << 20, [](size_t bytes) { std::cout << bytes << " bytes\n"; });
+    */
+    if (chunkSize == 0)
+      throw std::invalid_argument("Chunk size for do_io can't be 0");
+    if (inStream.eof())
+      return;
+    if (!inStream) // Like read_data did, e.g. a file that failed to open
+      throw std::ios::failure("do_io got an input stream in a failed state");
     const StreamConfigGuard scgi(inStream);
     const StreamConfigGuard scgo(outStream);
     outStream.exceptions(std::ios::failbit | std::ios::badbit);
-    outStream.write(data.data(), data.size());
+    std::array<std::vector<char>, 2> buffers;
+    buffers.at(0).resize(chunkSize);
+    const auto read_chunk = [&inStream, chunkSize](std::vector<char>& buffer) {
+      // sgetn only returns less than asked at the end of the input
+      if (buffer.size() < chunkSize)
+        buffer.resize(chunkSize);
+      return size_t(inStream.rdbuf()->sgetn(buffer.data(), std::streamsize(chunkSize)));
+    };
+    const auto check_short_read = [&inStream, chunkSize](size_t got) {
+      if (got < chunkSize && inStream.bad())
+        throw std::ios::failure("do_io failed to read the input stream");
+      return got;
+    };
+    size_t got = check_short_read(read_chunk(buffers.at(0)));
+    size_t total = 0;
+    for (size_t current = 0; got > 0; current ^= 1) {
+      std::future<size_t> next;
+      if (got == chunkSize)
+        next = ThreadPool::shared().submit(read_chunk, std::ref(buffers.at(current ^ 1)));
+      try {
+        outStream.write(buffers.at(current).data(), std::streamsize(got));
+        total += got;
+        if (onProgress)
+          onProgress(total);
+      }
+      catch (...) {
+        if (next.valid())
+          next.wait(); // The read still uses our buffer
+        throw;
+      }
+      got = next.valid() ? check_short_read(ThreadPool::shared().get(next)) : 0;
+    }
     outStream.flush();
   }
+  #ifndef _WIN32
+  size_t do_io(int inFd, int outFd, size_t chunkSize = IO_CHUNK_SIZE, const std::function<void(size_t)>& onProgress = {}) {
+    /*
+      Copy everything from `inFd` (from its current
+      offset) into `outFd` and return the amount of
+      bytes. The data stays in the kernel whenever
+      possible: copy_file_range for file to file,
+      sendfile from files and splice from pipes. Other
+      combinations fall back to a read/write loop.
+      Note:
+        Neither descriptor is closed. Non-blocking
+        ones are waited on with poll(), not spun on.
+    */
+    if (chunkSize == 0)
+      throw std::invalid_argument("Chunk size for do_io can't be 0");
+    struct stat inInfo = {}, outInfo = {};
+    if (::fstat(inFd, &inInfo) == -1 || ::fstat(outFd, &outInfo) == -1)
+      throw std::runtime_error(str_t("do_io failed to stat descriptors: ") + std::strerror(errno));
+    size_t total = 0;
+    const auto wait_ready = [&](std::initializer_list<pollfd> candidates) {
+      // EAGAIN from a non-blocking descriptor: sleep in poll() until the ones not ready yet are
+      std::array<pollfd, 2> waiting = {};
+      nfds_t count = 0;
+      for (pollfd candidate : candidates)
+        if (::poll(&candidate, 1, 0) == 0)
+          waiting.at(count++) = candidate;
+      if (count > 0 && ::poll(waiting.data(), count, -1) == -1 && errno != EINTR)
+        throw std::runtime_error(str_t("do_io failed to poll: ") + std::strerror(errno));
+    };
+    const auto pump = [&](auto&& transfer) {
+      /*
+        Run `transfer` until the input is drained.
+        Returns false if the method isn't supported for
+        these descriptors (and nothing was copied yet).
+      */
+      while (true) {
+        const ssize_t moved = transfer();
+        if (moved == 0)
+          return true;
+        if (moved < 0) {
+          if (errno == EINTR)
+            continue;
+          if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            wait_ready({{inFd, POLLIN, 0}, {outFd, POLLOUT, 0}});
+            continue;
+          }
+          if (total == 0 && (errno == EINVAL || errno == ENOSYS || errno == EXDEV || errno == EOPNOTSUPP || errno == EBADF))
+            return false;
+          throw std::runtime_error(str_t("do_io failed to transfer data: ") + std::strerror(errno));
+        }
+        total += size_t(moved);
+        if (onProgress)
+          onProgress(total);
+      }
+    };
+    #ifdef __linux__
+      if (S_ISREG(inInfo.st_mode) && S_ISREG(outInfo.st_mode))
+        if (pump([&] { return ::copy_file_range(inFd, nullptr, outFd, nullptr, chunkSize, 0); }))
+          return total;
+      if (S_ISREG(inInfo.st_mode))
+        if (pump([&] { return ::sendfile(outFd, inFd, nullptr, chunkSize); }))
+          return total;
+      if (S_ISFIFO(inInfo.st_mode) || S_ISFIFO(outInfo.st_mode))
+        if (pump([&] { return ::splice(inFd, nullptr, outFd, nullptr, chunkSize, SPLICE_F_MOVE | SPLICE_F_MORE); }))
+          return total;
+    #endif
+    std::vector<char> buffer(chunkSize);
+    const bool copied = pump([&]() -> ssize_t {
+      const ssize_t got = ::read(inFd, buffer.data(), buffer.size());
+      for (ssize_t written = 0; got > 0 && written < got;) {
+        const ssize_t now = ::write(outFd, buffer.data() + written, size_t(got - written));
+        if (now < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+          wait_ready({{outFd, POLLOUT, 0}});
+        else if (now < 0 && errno != EINTR)
+          throw std::runtime_error(str_t("do_io failed to write: ") + std::strerror(errno));
+        written += std::max<ssize_t>(now, 0);
+      }
+      return got;
+    });
+    if (!copied)
+      throw std::runtime_error(str_t("do_io failed to read: ") + std::strerror(errno));
+    return total;
+  }
+  #endif
 
 
 
   class TimeStamp { public:
     /*
       A wrapper around std::chrono
+      Note:
+        The broken down UTC fields are computed once
+        on construction (or set()) and then reused.
+        Assigning timePoint directly still works but
+        falls back to computing them on every call.
     */
-    std::chrono::system_clock::time_point timePoint;
+    using time_point_t = std::chrono::system_clock::time_point;
+    struct Civil {
+      // Broken down UTC time
+      int32_t year = 1970;
+      uint8_t month = 1;
+      uint8_t day = 1;
+      uint8_t hour = 0;
+      uint8_t minute = 0;
+      uint8_t second = 0;
+      uint32_t nanosecond = 0;
+    };
+    enum class Format {
+      Classic, // HH:MM:SS DD-MM-YYYY
+      Iso8601 // YYYY-MM-DDTHH:MM:SS.sssZ
+    };
+    static constexpr size_t MAX_LENGTH = 40; // What format_to writes at most
+    static constexpr std::array<char, 200> DIGIT_PAIRS = [] {
+      std::array<char, 200> pairs = {};
+      for (size_t i = 0; i < 100; ++i) {
+        pairs.at(i * 2) = char('0' + i / 10);
+        pairs.at(i * 2 + 1) = char('0' + i % 10);
+      }
+      return pairs;
+    }();
+    time_point_t timePoint;
+    Civil cache;
+    time_point_t cacheOf; // What `cache` was computed for
     
 
     // Contructors and error handling
-    TimeStamp() noexcept {timePoint = std::chrono::system_clock::now();}
-    TimeStamp(std::chrono::system_clock::time_point tp) : timePoint(tp) {}
+    TimeStamp() noexcept {set(std::chrono::system_clock::now());}
+    TimeStamp(time_point_t tp) {set(tp);}
     TimeStamp(int hour, int min, int sec, int day, int month, int year) {
       /*
         Create a time stamp from the given date and time
@@ -390,15 +1191,206 @@ namespace cslib {
       // Determine time
       if ((hour >= 24 || hour < 0) || (min >= 60 || min < 0) || (sec >= 60 || sec < 0))
         throw std::logic_error("Invalid time: " + i2s(hour) + ":" + i2s(min) + ":" + i2s(sec));
-      std::chrono::hh_mm_ss hms{
-        std::chrono::hours(hour) +
-        std::chrono::minutes(min) +
-        std::chrono::seconds(sec)
+      cache = Civil{int32_t(year), uint8_t(month), uint8_t(day), uint8_t(hour), uint8_t(min), uint8_t(sec), 0};
+      timePoint = cacheOf = from_civil(cache);
+    }
+
+
+    void set(time_point_t tp) noexcept {
+      // Change the time point and its cached fields together
+      timePoint = cacheOf = tp;
+      cache = to_civil(tp);
+    }
+    Civil civil() const noexcept {
+      return cacheOf == timePoint ? cache : to_civil(timePoint);
+    }
+
+
+    static Civil to_civil(time_point_t tp) noexcept {
+      const auto days = std::chrono::floor<std::chrono::days>(tp);
+      const std::chrono::year_month_day ymd(days);
+      Civil civil;
+      civil.year = int32_t(int(ymd.year()));
+      civil.month = uint8_t(unsigned(ymd.month()));
+      civil.day = uint8_t(unsigned(ymd.day()));
+      set_time_of_day(civil, tp - days);
+      return civil;
+    }
+    static void set_time_of_day(Civil& civil, time_point_t::duration sinceMidnight) noexcept {
+      const int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(sinceMidnight).count();
+      const int64_t seconds = nanos / 1'000'000'000;
+      civil.hour = uint8_t(seconds / 3600);
+      civil.minute = uint8_t(seconds / 60 % 60);
+      civil.second = uint8_t(seconds % 60);
+      civil.nanosecond = uint32_t(nanos % 1'000'000'000);
+    }
+    static time_point_t from_civil(const Civil& civil) noexcept {
+      const std::chrono::sys_days days(std::chrono::year_month_day(
+        std::chrono::year(civil.year), std::chrono::month(civil.month), std::chrono::day(civil.day)));
+      return time_point_t(days) + std::chrono::hours(civil.hour) + std::chrono::minutes(civil.minute) +
+        std::chrono::seconds(civil.second) + std::chrono::duration_cast<time_point_t::duration>(std::chrono::nanoseconds(civil.nanosecond));
+    }
+
+
+    char* format_to(char* out, Format format = Format::Classic, size_t subsecondDigits = 3) const noexcept {
+      /*
+        Write the time stamp into `out` (room for at least
+        MAX_LENGTH chars) without allocating and return
+        the end of what was written.
+        Note:
+          subsecondDigits (up to 9) is only used by Iso8601
+        Example:
+          char buffer[cslib::TimeStamp::MAX_LENGTH];
+          char* end = stamp.format_to(buffer, cslib::TimeStamp::Format::Iso8601);
+          std::cout << strv_t(buffer, end); // 2025-08-10T14:30:15.042Z
+      */
+      return write(out, civil(), format, subsecondDigits);
+    }
+    static char* write(char* out, const Civil& civil, Format format, size_t subsecondDigits) noexcept {
+      const auto pair = [&out](unsigned value) {
+        std::memcpy(out, DIGIT_PAIRS.data() + value * 2, 2);
+        out += 2;
       };
-      // Combine date and time into a time point
-      timePoint = std::chrono::system_clock::time_point(
-        std::chrono::sys_days(ymd).time_since_epoch() + hms.to_duration()
-      );
+      const auto year = [&] {
+        if (civil.year >= 0 && civil.year <= 9999) {
+          pair(unsigned(civil.year) / 100);
+          pair(unsigned(civil.year) % 100);
+        }
+        else
+          out = std::to_chars(out, out + 11, civil.year).ptr;
+      };
+      if (format == Format::Classic) {
+        pair(civil.hour); *out++ = ':'; pair(civil.minute); *out++ = ':'; pair(civil.second); *out++ = ' ';
+        pair(civil.day); *out++ = '-'; pair(civil.month); *out++ = '-'; year();
+        return out;
+      }
+      year(); *out++ = '-'; pair(civil.month); *out++ = '-'; pair(civil.day); *out++ = 'T';
+      pair(civil.hour); *out++ = ':'; pair(civil.minute); *out++ = ':'; pair(civil.second);
+      if (subsecondDigits > 0) {
+        std::array<char, 10> fraction = {'.'};
+        uint32_t nanos = civil.nanosecond;
+        for (size_t i = 9; i > 0; --i, nanos /= 10)
+          fraction.at(i) = char('0' + nanos % 10);
+        const size_t length = 1 + std::min<size_t>(subsecondDigits, 9);
+        std::memcpy(out, fraction.data(), length);
+        out += length;
+      }
+      *out++ = 'Z';
+      return out;
+    }
+
+
+    static std::optional<Civil> read(strv_t text, Format format = Format::Classic) noexcept {
+      /*
+        Parse what format_to writes (four digit years,
+        Iso8601 with optional fraction and 'Z') into its
+        fields. std::nullopt if it doesn't fit or isn't a
+        valid date.
+      */
+      if (text.size() < 19)
+        return std::nullopt;
+      bool ok = true;
+      const auto number = [&](size_t at, size_t count) {
+        unsigned value = 0;
+        for (size_t i = at; i < at + count; ++i) {
+          const unsigned digit = unsigned(text[i] - '0');
+          ok = ok && digit < 10;
+          value = value * 10 + digit;
+        }
+        return value;
+      };
+      const auto expect = [&](size_t at, char c) { ok = ok && text[at] == c; };
+      Civil civil;
+      if (format == Format::Classic) {
+        if (text.size() != 19)
+          return std::nullopt;
+        civil.hour = uint8_t(number(0, 2)); expect(2, ':'); civil.minute = uint8_t(number(3, 2)); expect(5, ':');
+        civil.second = uint8_t(number(6, 2)); expect(8, ' '); civil.day = uint8_t(number(9, 2)); expect(11, '-');
+        civil.month = uint8_t(number(12, 2)); expect(14, '-'); civil.year = int32_t(number(15, 4));
+      }
+      else {
+        civil.year = int32_t(number(0, 4)); expect(4, '-'); civil.month = uint8_t(number(5, 2)); expect(7, '-');
+        civil.day = uint8_t(number(8, 2)); ok = ok && (text[10] == 'T' || text[10] == ' ');
+        civil.hour = uint8_t(number(11, 2)); expect(13, ':'); civil.minute = uint8_t(number(14, 2)); expect(16, ':');
+        civil.second = uint8_t(number(17, 2));
+        size_t at = 19;
+        if (at < text.size() && text[at] == '.') {
+          const size_t first = ++at;
+          while (at < text.size() && unsigned(text[at] - '0') < 10)
+            ++at;
+          if (at == first)
+            return std::nullopt;
+          const size_t digits = std::min<size_t>(at - first, 9);
+          civil.nanosecond = number(first, digits);
+          for (size_t i = digits; i < 9; ++i)
+            civil.nanosecond *= 10;
+        }
+        if (at < text.size() && text[at] == 'Z')
+          ++at;
+        ok = ok && at == text.size();
+      }
+      if (!ok || civil.hour >= 24 || civil.minute >= 60 || civil.second >= 60 ||
+          !std::chrono::year_month_day(std::chrono::year(civil.year), std::chrono::month(civil.month), std::chrono::day(civil.day)).ok())
+        return std::nullopt;
+      return civil;
+    }
+    static std::optional<TimeStamp> parse(strv_t text, Format format = Format::Classic) noexcept {
+      /*
+        Example:
+          auto stamp = cslib::TimeStamp::parse("14:30:15 10-08-2025");
+          if (stamp)
+            std::cout << stamp->year(); // 2025
+      */
+      const std::optional<Civil> civil = read(text, format);
+      if (!civil)
+        return std::nullopt;
+      TimeStamp stamp(from_civil(*civil));
+      return stamp;
+    }
+
+
+    static str_t format_all(std::span<const time_point_t> timePoints, Format format = Format::Classic, size_t subsecondDigits = 3, char separator = '\n') {
+      /*
+        Format a whole column of time points, each one
+        followed by `separator`. The date is only worked
+        out again when the day changes, which is rare in
+        (sorted) logs.
+      */
+      str_t text;
+      text.resize_and_overwrite(timePoints.size() * (MAX_LENGTH + 1), [&](char* begin, size_t) {
+        char* out = begin;
+        Civil civil;
+        auto lastDay = std::chrono::sys_days::max();
+        for (const time_point_t& tp : timePoints) {
+          const auto day = std::chrono::floor<std::chrono::days>(tp);
+          if (day != lastDay) {
+            civil = to_civil(tp);
+            lastDay = day;
+          }
+          else
+            set_time_of_day(civil, tp - day);
+          out = write(out, civil, format, subsecondDigits);
+          *out++ = separator;
+        }
+        return size_t(out - begin);
+      });
+      return text;
+    }
+    static size_t parse_all(std::span<const strv_t> texts, std::span<time_point_t> out, Format format = Format::Classic) {
+      /*
+        Parse `texts` into `out` and return how many were
+        parsed. Stops at the first invalid one, so its
+        index is the returned value.
+      */
+      if (out.size() < texts.size())
+        throw std::invalid_argument("parse_all needs room for every text");
+      for (size_t i = 0; i < texts.size(); ++i) {
+        const std::optional<Civil> civil = read(texts[i], format);
+        if (!civil)
+          return i;
+        out[i] = from_civil(*civil);
+      }
+      return texts.size();
     }
 
 
@@ -407,38 +1399,26 @@ namespace cslib {
         Convert the time point to (almost) ISO 8601
         in format HH:MM:SS DD-MM-YYYY)..
       */
-      std::time_t time = std::chrono::system_clock::to_time_t(timePoint);
-      return (std::ostringstream() << std::put_time(std::gmtime(&time), "%H:%M:%S %d-%m-%Y")).str();
+      std::array<char, MAX_LENGTH> buffer;
+      return str_t(buffer.data(), format_to(buffer.data()));
     }
     size_t year() const noexcept {
-      auto ymd = std::chrono::year_month_day(std::chrono::floor<std::chrono::days>(timePoint));
-      return size_t(int(ymd.year()));
+      return size_t(civil().year);
     }
     size_t month() const noexcept {
-      auto ymd = std::chrono::year_month_day(std::chrono::floor<std::chrono::days>(timePoint));
-      return size_t(unsigned(ymd.month()));
+      return civil().month;
     }
     size_t day() const noexcept {
-      auto ymd = std::chrono::year_month_day(std::chrono::floor<std::chrono::days>(timePoint));
-      return size_t(unsigned(ymd.day()));
+      return civil().day;
     }
     size_t hour() const noexcept {
-      auto day_point = std::chrono::floor<std::chrono::days>(timePoint);
-      auto time_since_midnight = timePoint - day_point;
-      auto hms = std::chrono::hh_mm_ss(time_since_midnight);
-      return size_t(hms.hours().count());
+      return civil().hour;
     }
     size_t minute() const noexcept {
-      auto day_point = std::chrono::floor<std::chrono::days>(timePoint);
-      auto time_since_midnight = timePoint - day_point;
-      auto hms = std::chrono::hh_mm_ss(time_since_midnight);
-      return size_t(hms.minutes().count());
+      return civil().minute;
     }
     size_t second() const noexcept {
-      auto day_point = std::chrono::floor<std::chrono::days>(timePoint);
-      auto time_since_midnight = timePoint - day_point;
-      auto hms = std::chrono::hh_mm_ss(time_since_midnight);
-      return size_t(hms.seconds().count());
+      return civil().second;
     }
   };
 
@@ -487,6 +1467,286 @@ namespace cslib {
 
 
 
+  class AsyncLog { public:
+    /*
+      Background writer for AsyncOut. Producers push
+      records into a bounded lock-free ring buffer
+      (multi-producer, single-consumer) and one thread
+      stamps, batches and writes them, flushing each
+      target once per batch instead of once per record.
+      Note:
+        Target streams must outlive the records written
+        to them (call flush() before destroying them)
+    */
+    enum class OnFull {
+      Block, // Wait for a free slot
+      Drop, // Discard the record (counted in dropped())
+      Count // Discard, then log how many were lost once there is room again
+    };
+    struct Record {
+      std::chrono::system_clock::time_point when;
+      std::ostream* target = nullptr;
+      str_t text; // Prefix and message
+    };
+    struct alignas(64) Slot { // One per cache line, producers and the consumer don't share them
+      std::atomic<size_t> sequence;
+      Record record;
+    };
+    std::vector<Slot> slots;
+    size_t mask;
+    OnFull onFull;
+    std::atomic<size_t> enqueuePos = 0; // Shared by producers
+    size_t dequeuePos = 0; // Consumer only
+    std::atomic<size_t> published = 0; // Wakes up the consumer
+    std::atomic<bool> sleeping = false; // Consumer is (about to be) waiting on `published`
+    std::atomic<size_t> written = 0; // Records fully written and flushed
+    std::atomic<size_t> droppedCount = 0;
+    size_t droppedReported = 0; // Consumer only
+    std::atomic<bool> stopping = false;
+    std::chrono::sys_seconds stampSecond{}; // Consumer only
+    str_t stamp; // Consumer only, formatted once per second
+    std::thread consumer;
+
+
+    explicit AsyncLog(size_t capacity = 8192, OnFull policy = OnFull::Block) : onFull(policy) {
+      if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+        throw std::invalid_argument("AsyncLog capacity must be a power of two (got " + i2s(capacity) + ")");
+      slots = std::vector<Slot>(capacity);
+      mask = capacity - 1;
+      for (size_t i = 0; i < capacity; ++i)
+        slots.at(i).sequence.store(i, std::memory_order_relaxed);
+      consumer = std::thread([this] { drain(); });
+    }
+    ~AsyncLog() noexcept {
+      shutdown();
+    }
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog(AsyncLog&&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+    AsyncLog& operator=(AsyncLog&&) = delete;
+
+
+    static sptr<AsyncLog> shared() {
+      static sptr<AsyncLog> log = std::make_shared<AsyncLog>();
+      return log;
+    }
+    size_t dropped() const noexcept { return droppedCount; }
+
+
+    bool push(Record&& record) noexcept {
+      /*
+        Returns false if the record was dropped
+      */
+      if (stopping) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      size_t pos = enqueuePos.load(std::memory_order_relaxed);
+      while (true) {
+        Slot& slot = slots[pos & mask];
+        const std::ptrdiff_t diff = std::ptrdiff_t(slot.sequence.load(std::memory_order_acquire)) - std::ptrdiff_t(pos);
+        if (diff == 0) {
+          if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            slot.record = std::move(record);
+            slot.sequence.store(pos + 1, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the one in drain()
+            if (sleeping.load(std::memory_order_relaxed) && sleeping.exchange(false)) { // Only pay for waking when needed
+              published.fetch_add(1, std::memory_order_release);
+              published.notify_one();
+            }
+            return true;
+          }
+        }
+        else if (diff < 0) { // Full
+          if (onFull != OnFull::Block) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+          }
+          std::this_thread::yield();
+          pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+        else
+          pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+
+
+    void flush() noexcept {
+      /*
+        Barrier: returns once everything pushed before
+        the call has been written and flushed
+      */
+      const size_t upTo = enqueuePos.load(std::memory_order_acquire);
+      for (size_t done = written.load(std::memory_order_acquire); done < upTo; done = written.load(std::memory_order_acquire)) {
+        if (!consumer.joinable())
+          return; // Already shut down
+        written.wait(done, std::memory_order_acquire);
+      }
+    }
+    void shutdown() noexcept {
+      /*
+        Write everything that's left and stop the
+        background thread. Later records are dropped.
+      */
+      if (!consumer.joinable())
+        return;
+      flush();
+      stopping = true;
+      published.fetch_add(1, std::memory_order_release);
+      published.notify_one();
+      consumer.join();
+    }
+
+
+    void drain() noexcept {
+      std::vector<std::ostream*> touched;
+      while (true) {
+        const size_t seen = published.load(std::memory_order_acquire);
+        touched.clear();
+        while (true) { // One batch: everything ready right now
+          Slot& slot = slots[dequeuePos & mask];
+          if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1)
+            break;
+          write(slot.record);
+          if (!contains(touched, slot.record.target))
+            touched.push_back(slot.record.target);
+          slot.record.text.clear();
+          slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+          ++dequeuePos;
+        }
+        for (std::ostream* target : touched)
+          try { target->flush(); } catch (...) { /* ignore */ }
+        if (!touched.empty()) {
+          written.store(dequeuePos, std::memory_order_release);
+          written.notify_all();
+        }
+        else if (stopping && dequeuePos == enqueuePos.load(std::memory_order_acquire))
+          return;
+        else {
+          sleeping.store(true, std::memory_order_relaxed);
+          std::atomic_thread_fence(std::memory_order_seq_cst); // Either a producer sees `sleeping` or we see its record
+          if (slots[dequeuePos & mask].sequence.load(std::memory_order_acquire) == dequeuePos + 1)
+            sleeping.store(false, std::memory_order_relaxed);
+          else
+            published.wait(seen, std::memory_order_acquire);
+        }
+      }
+    }
+    void write(const Record& record) noexcept {
+      const std::chrono::sys_seconds second = std::chrono::floor<std::chrono::seconds>(record.when);
+      if (second != stampSecond || stamp.empty()) {
+        stampSecond = second;
+        stamp = '[' + TimeStamp(record.when).as_str() + ']';
+      }
+      try {
+        if (onFull == OnFull::Count && droppedReported != droppedCount.load(std::memory_order_relaxed)) {
+          const size_t lost = droppedCount.load(std::memory_order_relaxed);
+          *record.target << stamp << "[" << lost - droppedReported << " log records dropped]\n";
+          droppedReported = lost;
+        }
+        record.target->write(stamp.data(), stamp.size());
+        record.target->write(record.text.data(), record.text.size());
+      } catch (...) { /* A broken target shouldn't kill the logger */ }
+    }
+  };
+
+
+
+  class AsyncOut : public Out { public:
+    /*
+      Same as Out but formatting and writing happen on
+      AsyncLog's background thread so the caller only
+      pays for building the message. Each full
+      expression becomes one record.
+      Usage:
+        cslib::AsyncOut info(std::cout, "INFO:", cslib::Green);
+        info << "Processed " << n << " items\n";
+        info.flush(); // Wait until it's actually written
+    */
+    sptr<AsyncLog> backend;
+    AsyncOut(std::ostream& outTo_, strv_t prefsv = "", strv_t color = "", sptr<AsyncLog> backend_ = AsyncLog::shared())
+      : Out(outTo_, prefsv, color), backend(std::move(backend_)) {
+      if (!backend)
+        throw std::invalid_argument("AsyncOut needs a backend");
+    }
+
+
+    class Line { public:
+      // Collects one record and hands it over upon destruction
+      const AsyncOut* owner;
+      AsyncLog::Record record;
+      bool manipulated = false; // Integers go through the formatter after std::hex and co.
+      explicit Line(const AsyncOut& owner_) : owner(&owner_) {
+        record.when = std::chrono::system_clock::now();
+        record.target = &owner->outTo;
+        record.text.reserve(owner->prefix.size() + 64);
+        record.text = owner->prefix;
+        if (formatter_dirty()) { // Manipulators only last for one line
+          formatter().flags(std::ios::dec | std::ios::skipws);
+          formatter().precision(6);
+          formatter().fill(' ');
+          formatter_dirty() = false;
+        }
+      }
+      Line(Line&& other) noexcept : owner(std::exchange(other.owner, nullptr)), record(std::move(other.record)), manipulated(other.manipulated) {}
+      Line(const Line&) = delete;
+      Line& operator=(const Line&) = delete;
+      Line& operator=(Line&&) = delete;
+      ~Line() noexcept {
+        if (owner)
+          owner->backend->push(std::move(record));
+      }
+      Line& operator<<(auto&& msg) {
+        using msg_t = std::decay_t<decltype(msg)>;
+        if constexpr (std::is_convertible_v<const msg_t&, strv_t>)
+          record.text += strv_t(msg);
+        else if constexpr (std::is_same_v<msg_t, char>)
+          record.text += msg;
+        else {
+          if constexpr (std::is_integral_v<msg_t> && !std::is_same_v<msg_t, bool>)
+            if (!manipulated) {
+              std::array<char, 24> digits;
+              record.text.append(digits.data(), std::to_chars(digits.data(), digits.data() + digits.size(), msg).ptr);
+              return *this;
+            }
+          formatter().str("");
+          formatter() << std::forward<decltype(msg)>(msg);
+          record.text += formatter().view();
+          if (formatter().width() != 0 || formatter().flags() != (std::ios::dec | std::ios::skipws) || formatter().precision() != 6 || formatter().fill() != ' ')
+            manipulated = formatter_dirty() = true; // std::setw, std::setprecision, ...
+        }
+        return *this;
+      }
+      Line& operator<<(std::ostream& (*manipulator)(std::ostream&)) {
+        // std::endl, std::hex, ...
+        manipulated = true;
+        formatter_dirty() = true;
+        formatter().str("");
+        formatter() << manipulator;
+        record.text += formatter().view();
+        return *this;
+      }
+      static std::ostringstream& formatter() {
+        thread_local std::ostringstream stream;
+        return stream;
+      }
+      static bool& formatter_dirty() {
+        thread_local bool dirty = false;
+        return dirty;
+      }
+    };
+    Line operator<<(auto&& msg) const {
+      Line line(*this);
+      line << std::forward<decltype(msg)>(msg);
+      return line;
+    }
+    void flush() const noexcept {
+      backend->flush();
+    }
+  };
+
+
+
   class Benchmark { public:
     /*
       Measures the time taken by a function or a block of code.
@@ -502,14 +1762,300 @@ namespace cslib {
     void reset() noexcept {
       startTime = std::chrono::high_resolution_clock::now();
     }
-    double elapsed_ns() noexcept {
-      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+    double elapsed_ns() noexcept {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - startTime).count();
+    }
+    double elapsed_ms() noexcept {
+      return elapsed_ns() / 1'000'000.0f; // Convert nanoseconds to milliseconds
+    }
+    double elapsed_us() noexcept {
+      return elapsed_ns() / 1'000.0f; // Convert nanoseconds to microseconds
+    }
+  };
+
+
+
+  template <typename T>
+  inline void do_not_optimize(const T& value) noexcept {
+    /*
+      Pretend `value` is read so the compiler can't
+      drop the computation that produced it.
+      Example:
+        cslib::do_not_optimize(std::sqrt(x));
+    */
+    #if defined(__GNUC__) || defined(__clang__)
+      asm volatile("" : : "r,m"(value) : "memory");
+    #else
+      static volatile const void* sink;
+      sink = &value;
+    #endif
+  }
+  inline void clobber() noexcept {
+    // Pretend all memory was read and written (forces pending stores)
+    #if defined(__GNUC__) || defined(__clang__)
+      asm volatile("" : : : "memory");
+    #else
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+    #endif
+  }
+  inline uint64_t read_cycles() noexcept {
+    /*
+      Cheap cycle-ish counter (TSC on x86, virtual
+      counter on ARM64, nanoseconds elsewhere).
+      Note:
+        Only meaningful as a difference on the same core
+    */
+    #if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+    #elif defined(__aarch64__)
+      uint64_t ticks;
+      asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+      return ticks;
+    #else
+      return uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+    #endif
+  }
+
+
+
+  class PerfCounters { public:
+    /*
+      Hardware counters through Linux' perf_event_open
+      (user space only). Unavailable counters (other
+      OSes, VMs, perf_event_paranoid) read as nullopt.
+      Example:
+        cslib::PerfCounters counters;
+        counters.start();
+        // Do something
+        std::optional<uint64_t> misses = counters.stop().at(cslib::PerfCounters::CacheMisses);
+    */
+    enum Event { Cycles, Instructions, CacheMisses, EVENT_COUNT };
+    std::array<int, EVENT_COUNT> fds;
+
+
+    PerfCounters() noexcept {
+      fds.fill(-1);
+      #ifdef __linux__
+        const std::array<uint64_t, EVENT_COUNT> configs = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+          perf_event_attr attr = {};
+          attr.type = PERF_TYPE_HARDWARE;
+          attr.size = sizeof(attr);
+          attr.config = configs.at(i);
+          attr.disabled = 1;
+          attr.exclude_kernel = 1;
+          attr.exclude_hv = 1;
+          fds.at(i) = int(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+      #endif
+    }
+    ~PerfCounters() noexcept {
+      #ifndef _WIN32
+        for (int fd : fds)
+          if (fd != -1)
+            ::close(fd);
+      #endif
+    }
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+
+    bool available() const noexcept {
+      return std::ranges::any_of(fds, [](int fd) { return fd != -1; });
+    }
+    void start() noexcept {
+      #ifdef __linux__
+        for (int fd : fds)
+          if (fd != -1) {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+          }
+      #endif
+    }
+    std::array<std::optional<uint64_t>, EVENT_COUNT> stop() noexcept {
+      std::array<std::optional<uint64_t>, EVENT_COUNT> result;
+      #ifdef __linux__
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+          if (fds.at(i) == -1)
+            continue;
+          ::ioctl(fds.at(i), PERF_EVENT_IOC_DISABLE, 0);
+          uint64_t count = 0;
+          if (::read(fds.at(i), &count, sizeof(count)) == ssize_t(sizeof(count)))
+            result.at(i) = count;
+        }
+      #endif
+      return result;
+    }
+  };
+
+
+
+  struct BenchmarkStats {
+    // Times are per iteration, counters are per iteration as well
+    str_t name;
+    size_t samples = 0;
+    size_t iterations = 0; // Per sample
+    double minNs = 0, medianNs = 0, meanNs = 0, p99Ns = 0, maxNs = 0, stddevNs = 0;
+    std::optional<double> cycles;
+    std::optional<double> instructions;
+    std::optional<double> cacheMisses;
+  };
+  class BenchmarkSuite { public:
+    /*
+      Statistical micro benchmarks on top of Benchmark.
+      Every measurement warms up, calibrates how many
+      iterations fill `minSampleMs`, takes `samples`
+      samples and reports min/median/p99/stddev per
+      iteration (plus cycles and hardware counters if
+      asked for and available).
+      Example:
+        cslib::BenchmarkSuite suite;
+        suite.measure("to_str", [] { cslib::do_not_optimize(cslib::to_str(42)); });
+        suite.print(std::cout);
+        std::ofstream("bench.json") << suite.to_json();
+    */
+    size_t samples = 30;
+    double minSampleMs = 1.0;
+    double warmupMs = 10.0;
+    bool countCycles = true;
+    bool usePerfCounters = false;
+    std::vector<BenchmarkStats> results;
+
+
+    template <typename F>
+    requires std::invocable<F&>
+    const BenchmarkStats& measure(strv_t name, F&& f) {
+      if (samples == 0)
+        throw std::invalid_argument("BenchmarkSuite needs at least one sample");
+      const auto run = [&f](size_t iterations) {
+        Benchmark timer;
+        for (size_t i = 0; i < iterations; ++i) {
+          std::invoke(f);
+          clobber();
+        }
+        return timer.elapsed_ns();
+      };
+
+      // Warmup, then calibrate until one sample takes long enough to time reliably
+      for (Benchmark warmup; warmup.elapsed_ms() < warmupMs;)
+        run(1);
+      size_t iterations = 1;
+      while (run(iterations) < minSampleMs * 1'000'000.0 && iterations < (size_t(1) << 40))
+        iterations *= 2;
+
+      std::vector<double> perIteration, cycles;
+      std::array<std::vector<double>, PerfCounters::EVENT_COUNT> counted;
+      std::optional<PerfCounters> counters;
+      if (usePerfCounters)
+        counters.emplace();
+      for ([[maybe_unused]] size_t _ = 0; _ < samples; ++_) {
+        if (counters)
+          counters->start();
+        const uint64_t cyclesBefore = read_cycles();
+        perIteration.push_back(run(iterations) / double(iterations));
+        const uint64_t cyclesAfter = read_cycles();
+        if (counters)
+          for (size_t event = 0; const std::optional<uint64_t>& count : counters->stop()) {
+            if (count)
+              counted.at(event).push_back(double(*count) / double(iterations));
+            ++event;
+          }
+        cycles.push_back(double(cyclesAfter - cyclesBefore) / double(iterations));
+      }
+
+      const auto median_of = [](std::vector<double> values) -> std::optional<double> {
+        if (values.empty())
+          return std::nullopt;
+        std::ranges::sort(values);
+        return values.at(values.size() / 2);
+      };
+      BenchmarkStats stats;
+      stats.name = name;
+      stats.samples = samples;
+      stats.iterations = iterations;
+      std::ranges::sort(perIteration);
+      stats.minNs = perIteration.front();
+      stats.maxNs = perIteration.back();
+      stats.medianNs = perIteration.at(perIteration.size() / 2);
+      stats.p99Ns = perIteration.at(size_t(std::ceil(0.99 * double(perIteration.size()))) - 1);
+      for (double value : perIteration)
+        stats.meanNs += value / double(perIteration.size());
+      for (double value : perIteration)
+        stats.stddevNs += (value - stats.meanNs) * (value - stats.meanNs) / double(perIteration.size());
+      stats.stddevNs = std::sqrt(stats.stddevNs);
+      if (countCycles)
+        stats.cycles = median_of(cycles);
+      stats.instructions = median_of(counted.at(PerfCounters::Instructions));
+      stats.cacheMisses = median_of(counted.at(PerfCounters::CacheMisses));
+      if (std::optional<double> perfCycles = median_of(counted.at(PerfCounters::Cycles)))
+        stats.cycles = perfCycles; // Real cycles beat the TSC's reference ticks
+      results.push_back(std::move(stats));
+      return results.back();
+    }
+
+
+    str_t to_json() const {
+      const auto quoted = [](strv_t text) {
+        str_t result = "\"";
+        for (char c : text)
+          if (c == '"' || c == '\\')
+            result += str_t("\\") + c;
+          else if (uint8_t(c) < 0x20)
+            result += ' ';
+          else
+            result += c;
+        return result + '"';
+      };
+      const auto optional = [](const std::optional<double>& value) {
+        return value ? to_str(*value) : str_t("null");
+      };
+      std::ostringstream json;
+      json << std::setprecision(10) << "[\n";
+      for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkStats& s = results.at(i);
+        json << "  {\"name\": " << quoted(s.name) << ", \"samples\": " << s.samples << ", \"iterations\": " << s.iterations
+             << ", \"min_ns\": " << s.minNs << ", \"median_ns\": " << s.medianNs << ", \"mean_ns\": " << s.meanNs
+             << ", \"p99_ns\": " << s.p99Ns << ", \"max_ns\": " << s.maxNs << ", \"stddev_ns\": " << s.stddevNs
+             << ", \"cycles\": " << optional(s.cycles) << ", \"instructions\": " << optional(s.instructions)
+             << ", \"cache_misses\": " << optional(s.cacheMisses) << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+      }
+      json << "]\n";
+      return json.str();
     }
-    double elapsed_ms() noexcept {
-      return elapsed_ns() / 1'000'000.0f; // Convert nanoseconds to milliseconds
+    str_t to_csv() const {
+      const auto optional = [](const std::optional<double>& value) {
+        return value ? to_str(*value) : str_t();
+      };
+      std::ostringstream csv;
+      csv << std::setprecision(10) << "name,samples,iterations,min_ns,median_ns,mean_ns,p99_ns,max_ns,stddev_ns,cycles,instructions,cache_misses\n";
+      for (const BenchmarkStats& s : results) {
+        str_t name = s.name;
+        std::ranges::replace(name, ',', ';');
+        csv << name << ',' << s.samples << ',' << s.iterations << ',' << s.minNs << ',' << s.medianNs << ',' << s.meanNs << ','
+            << s.p99Ns << ',' << s.maxNs << ',' << s.stddevNs << ',' << optional(s.cycles) << ',' << optional(s.instructions) << ','
+            << optional(s.cacheMisses) << '\n';
+      }
+      return csv.str();
     }
-    double elapsed_us() noexcept {
-      return elapsed_ns() / 1'000.0f; // Convert nanoseconds to microseconds
+    void print(std::ostream& out) const {
+      // Not StreamConfigGuard, it would seek back over the report
+      const std::ios::fmtflags flags = out.flags();
+      const std::streamsize precision = out.precision();
+      const char fill = out.fill();
+      out << std::fixed << std::setprecision(1);
+      for (const BenchmarkStats& s : results) {
+        out << "  " << std::left << std::setw(32) << s.name << std::right
+            << " median " << std::setw(12) << s.medianNs << "ns"
+            << "  min " << std::setw(12) << s.minNs << "ns"
+            << "  p99 " << std::setw(12) << s.p99Ns << "ns"
+            << "  stddev " << std::setw(10) << s.stddevNs << "ns";
+        if (s.cycles)
+          out << "  " << std::setw(10) << *s.cycles << " cycles";
+        out << '\n';
+      }
+      out.flags(flags);
+      out.precision(precision);
+      out.fill(fill);
     }
   };
 
@@ -595,6 +2141,8 @@ namespace cslib {
 
 
     // Abstract class shouldn't be instantiated
+    friend class Folder; // Builds entries from already resolved paths
+    friend class FolderIndex;
     protected: Road() = default;
     protected: Road(stdfs::path where) {
       /*
@@ -637,6 +2185,169 @@ namespace cslib {
 
 
 
+  class MappedFile { public:
+    /*
+      Read-only, zero-copy view of a file's content.
+      Regular files are mmap'ed, everything else (pipes,
+      FIFOs, character devices; see BizarreRoad) falls
+      back to a single bulk read into a presized buffer.
+      Note:
+        The view is only valid as long as the object
+        lives. Changes to the file while mapped may or
+        may not show up.
+      Example:
+        cslib::MappedFile mapped(cslib::File("/var/log/huge.log"));
+        for (strv_t line : cslib::separate(mapped.view(), "\n")) ...
+    */
+    enum class Access {
+      Normal, // No hint
+      Sequential, // Aggressive read-ahead, pages dropped behind
+      Random // No read-ahead
+    };
+    const char* begin = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    std::vector<char> buffer; // Only used by the fallback
+
+
+    MappedFile(const stdfs::path& where, Access access = Access::Sequential) {
+      #ifndef _WIN32
+        const int fd = ::open(where.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+          throw std::runtime_error("Failed to open '" + where.string() + "': " + std::strerror(errno));
+        struct FdCloser { int fd; ~FdCloser() { ::close(fd); } } closer{fd};
+        struct stat info = {};
+        if (::fstat(fd, &info) == -1)
+          throw std::runtime_error("Failed to stat '" + where.string() + "': " + std::strerror(errno));
+        const size_t expected = S_ISREG(info.st_mode) ? size_t(info.st_size) : 0;
+        if (expected > 0) {
+          void* mapping = ::mmap(nullptr, expected, PROT_READ, MAP_PRIVATE, fd, 0);
+          if (mapping != MAP_FAILED) {
+            begin = static_cast<const char*>(mapping);
+            length = expected;
+            mapped = true;
+            advise(access);
+            return;
+          }
+        }
+        // Pipes, special files or mmap refused: one presized bulk read
+        length = read_all(fd, buffer, expected, where);
+      #else
+        (void)access;
+        std::ifstream file(where, std::ios::in | std::ios::binary);
+        if (!file)
+          throw std::runtime_error("Failed to open '" + where.string() + "'");
+        if (stdfs::is_regular_file(where)) {
+          buffer.resize(stdfs::file_size(where));
+          file.read(buffer.data(), buffer.size());
+          length = size_t(file.gcount());
+        }
+        else {
+          std::vector<char> data = read_data(file);
+          buffer = std::move(data);
+          length = buffer.size();
+        }
+      #endif
+      buffer.resize(length);
+      buffer.shrink_to_fit();
+      begin = buffer.data();
+    }
+    ~MappedFile() noexcept {
+      #ifndef _WIN32
+        if (mapped)
+          ::munmap(const_cast<char*>(begin), length);
+      #endif
+    }
+    MappedFile(MappedFile&& other) noexcept :
+      begin(std::exchange(other.begin, nullptr)),
+      length(std::exchange(other.length, 0)),
+      mapped(std::exchange(other.mapped, false)),
+      buffer(std::move(other.buffer)) {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+
+    #ifndef _WIN32
+    template <typename Buffer>
+    static size_t read_all(int fd, Buffer& buffer, size_t expected, const stdfs::path& where) {
+      // read() until EOF into `buffer` sized for `expected` bytes, returns how many were read
+      buffer.resize(expected > 0 ? expected : 64 * 1024);
+      size_t length = 0;
+      char scratch[512]; // Probes for EOF once full, so an exact fit never grows
+      while (true) {
+        const bool full = length == buffer.size();
+        const ssize_t got = full ?
+          ::read(fd, scratch, sizeof(scratch)) :
+          ::read(fd, buffer.data() + length, buffer.size() - length);
+        if (got == 0)
+          break;
+        if (got < 0) {
+          if (errno == EINTR)
+            continue;
+          throw std::runtime_error("Failed to read '" + where.string() + "': " + std::strerror(errno));
+        }
+        if (full) { // Grew since fstat() or not a regular file
+          buffer.resize(buffer.size() * 2);
+          std::memcpy(buffer.data() + length, scratch, size_t(got));
+        }
+        length += size_t(got);
+      }
+      return length;
+    }
+    #endif
+    static str_t read_copy(const stdfs::path& where) {
+      /*
+        Whole content as a string through one presized
+        read. Unlike a mapping, a file truncated while
+        being read just gives less data (no SIGBUS).
+      */
+      #ifndef _WIN32
+        const int fd = ::open(where.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+          throw std::runtime_error("Failed to open '" + where.string() + "': " + std::strerror(errno));
+        struct FdCloser { int fd; ~FdCloser() { ::close(fd); } } closer{fd};
+        struct stat info = {};
+        if (::fstat(fd, &info) == -1)
+          throw std::runtime_error("Failed to stat '" + where.string() + "': " + std::strerror(errno));
+        str_t text;
+        text.resize(read_all(fd, text, S_ISREG(info.st_mode) ? size_t(info.st_size) : 0, where));
+        if (text.capacity() - text.size() > text.size() / 4)
+          text.shrink_to_fit(); // Overshot (grew while reading, or a pipe)
+        return text;
+      #else
+        return str_t(MappedFile(where).view()); // Never mapped on Windows
+      #endif
+    }
+
+
+    strv_t view() const noexcept { return strv_t(begin, length); }
+    std::span<const std::byte> bytes() const noexcept { return std::as_bytes(std::span<const char>(begin, length)); }
+    size_t size() const noexcept { return length; }
+    bool is_mapped() const noexcept { return mapped; }
+
+
+    void advise(Access access) const noexcept {
+      /*
+        Change the read-ahead hint for the kernel. Does
+        nothing for buffered (non-mapped) content.
+      */
+      #ifndef _WIN32
+        if (!mapped)
+          return;
+        switch (access) {
+          case Access::Normal: ::madvise(const_cast<char*>(begin), length, MADV_NORMAL); break;
+          case Access::Sequential: ::madvise(const_cast<char*>(begin), length, MADV_SEQUENTIAL); break;
+          case Access::Random: ::madvise(const_cast<char*>(begin), length, MADV_RANDOM); break;
+        }
+      #else
+        (void)access;
+      #endif
+    }
+  };
+
+
+
   class File : public Road { public:
     /*
       Child class of RouteToFile that represents a file.
@@ -656,13 +2367,21 @@ namespace cslib {
 
 
     str_t read_text() const {
-      std::ifstream file(isAt, std::ios::in);
-      std::vector<char> data = read_data(file);
-      return str_t(data.begin(), data.end());
+      // A copy is made anyway, so no mapping (see MappedFile::read_copy)
+      return MappedFile::read_copy(isAt);
+    }
+    MappedFile map(MappedFile::Access access = MappedFile::Access::Sequential) const {
+      /*
+        Zero-copy read-only access to the content.
+        Example:
+          MappedFile content = File("data.csv").map();
+          strv_t text = content.view();
+      */
+      return MappedFile(isAt, access);
     }
-    void edit_text(const str_t& newText) const {
+    void edit_text(strv_t newText) const {
       std::ofstream file(isAt, std::ios::out | std::ios::trunc);
-      std::istringstream streamedData(newText);
+      std::ispanstream streamedData(std::span<const char>(newText.data(), newText.size())); // No copy of the text
       return do_io(streamedData, file);
     }
 
@@ -679,6 +2398,14 @@ namespace cslib {
 
 
 
+  struct WalkFilter {
+    // Which entries Folder::walk reports
+    str_t glob = {}; // Matched against the entry's name, empty matches everything
+    std::vector<str_t> extensions = {}; // Like ".txt", empty matches everything
+    size_t maxDepth = std::numeric_limits<size_t>::max(); // 0 = direct entries only
+    bool directories = true; // Report directories (they're descended into either way)
+    bool files = true; // Report everything that isn't a directory
+  };
   class Folder : public Road { public:
     /*
       Child class of Path that represents a folder.
@@ -703,13 +2430,92 @@ namespace cslib {
 
 
     std::vector<Road> list() const {
+      /*
+        Note:
+          Only resolves this folder once instead of
+          every entry (a non-symlink entry of a
+          canonical folder is canonical already)
+      */
       std::vector<Road> result;
-      for (const stdfs::directory_entry& entry : stdfs::directory_iterator(isAt))
-        result.emplace_back(Road::create_self(entry.path()));
+      const stdfs::path base = stdfs::canonical(isAt);
+      for (const stdfs::directory_entry& entry : stdfs::directory_iterator(base)) {
+        if (entry.is_symlink()) {
+          result.emplace_back(Road::create_self(entry.path()));
+          continue;
+        }
+        Road road;
+        road.isAt = entry.path();
+        result.push_back(std::move(road));
+      }
       return result;
     }
 
 
+    void walk(const std::function<void(const stdfs::directory_entry&, size_t)>& onEntry, const WalkFilter& filter = {}, ThreadPool& pool = ThreadPool::shared()) const {
+      /*
+        Recursively visit every entry below this folder,
+        handing out subdirectories to the pool's workers.
+        `onEntry(entry, depth)` is called as soon as an
+        entry is found, one call at a time (but from any
+        thread and in no particular order). Symlinks are
+        reported but not followed, unreadable folders
+        are skipped.
+        Note:
+          The entries carry the type read from the
+          directory itself, so entry.is_directory() and
+          friends don't touch the disk again.
+        Example:
+          folder.walk([](const stdfs::directory_entry& entry, size_t depth) {
+            std::cout << entry.path() << '\n';
+          }, {.glob = "*.h++", .maxDepth = 3});
+      */
+      struct Shared {
+        std::mutex callbackLock;
+        std::atomic<size_t> pending = 0;
+        std::mutex errorLock;
+        std::exception_ptr error;
+      } shared;
+      const auto wanted = [&filter](const stdfs::directory_entry& entry, bool isDirectory) {
+        if (isDirectory ? !filter.directories : !filter.files)
+          return false;
+        if (!filter.glob.empty() && !glob_match(filter.glob, entry.path().filename().string()))
+          return false;
+        return filter.extensions.empty() || contains(filter.extensions, entry.path().extension().string());
+      };
+      std::function<void(stdfs::path, size_t)> scan = [&](stdfs::path directory, size_t depth) {
+        try {
+          std::error_code ec;
+          for (stdfs::directory_iterator it(directory, stdfs::directory_options::skip_permission_denied, ec), end; !ec && it != end; it.increment(ec)) {
+            const stdfs::directory_entry& entry = *it;
+            std::error_code typeEc;
+            const bool isDirectory = !entry.is_symlink(typeEc) && entry.is_directory(typeEc);
+            if (wanted(entry, isDirectory)) {
+              std::lock_guard<std::mutex> guard(shared.callbackLock);
+              onEntry(entry, depth);
+            }
+            if (isDirectory && depth < filter.maxDepth) {
+              shared.pending.fetch_add(1);
+              pool.push([&scan, path = entry.path(), depth] { scan(path, depth + 1); });
+            }
+          }
+        }
+        catch (...) {
+          std::lock_guard<std::mutex> guard(shared.errorLock);
+          if (!shared.error)
+            shared.error = std::current_exception();
+        }
+        shared.pending.fetch_sub(1);
+      };
+      shared.pending = 1;
+      scan(isAt, 0);
+      while (shared.pending > 0) // Help out instead of blocking a (possibly pool) thread
+        if (!pool.run_pending_task())
+          std::this_thread::yield();
+      if (shared.error)
+        std::rethrow_exception(shared.error);
+    }
+
+
     std::optional<Road> find(strv_t name) const {
       /*
         Check if the folder contains a file or folder with
@@ -799,7 +2605,35 @@ namespace cslib {
       Copying self with custom options for extra
       control
     */
-    stdfs::copy_file(isAt, newLocation / name(), options);
+    #ifndef _WIN32
+      // Same rules as stdfs::copy_file but the bytes go through do_io's kernel-side copy
+      const stdfs::path target = newLocation / name();
+      if (stdfs::exists(target)) {
+        if (stdfs::equivalent(isAt, target))
+          throw stdfs::filesystem_error("Can't copy a file onto itself", isAt, target, std::make_error_code(std::errc::invalid_argument));
+        if ((options & stdfs::copy_options::skip_existing) != stdfs::copy_options::none)
+          return File(target);
+        if ((options & stdfs::copy_options::update_existing) != stdfs::copy_options::none && stdfs::last_write_time(target) >= stdfs::last_write_time(isAt))
+          return File(target);
+        if ((options & (stdfs::copy_options::overwrite_existing | stdfs::copy_options::update_existing)) == stdfs::copy_options::none)
+          throw stdfs::filesystem_error("File already exists", isAt, target, std::make_error_code(std::errc::file_exists));
+      }
+      const int inFd = ::open(isAt.c_str(), O_RDONLY | O_CLOEXEC);
+      if (inFd == -1)
+        throw std::runtime_error("Failed to open '" + str() + "': " + std::strerror(errno));
+      struct FdCloser { int fd; ~FdCloser() { ::close(fd); } } inCloser{inFd};
+      struct stat info = {};
+      if (::fstat(inFd, &info) == -1)
+        throw std::runtime_error("Failed to stat '" + str() + "': " + std::strerror(errno));
+      const int outFd = ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, info.st_mode & 07777);
+      if (outFd == -1)
+        throw std::runtime_error("Failed to open '" + target.string() + "': " + std::strerror(errno));
+      FdCloser outCloser{outFd};
+      do_io(inFd, outFd);
+      ::fchmod(outFd, info.st_mode & 07777); // O_CREAT is subject to umask and leaves existing files as they were
+    #else
+      stdfs::copy_file(isAt, newLocation / name(), options);
+    #endif
     if (!stdfs::exists(newLocation / name()))
       throw std::runtime_error("Failed to copy file to '" + (newLocation / name()).string() + "'");
     return File(newLocation / name());
@@ -807,6 +2641,195 @@ namespace cslib {
 
 
 
+  class FolderIndex { public:
+    /*
+      In-memory index of every entry below a folder
+      with O(1) lookups by relative path. On Linux it
+      watches the tree through inotify and refresh()
+      only applies what changed since; elsewhere
+      refresh() rebuilds the whole index.
+      Example:
+        cslib::FolderIndex index(cslib::Folder("/srv/data"));
+        if (std::optional<Road> hit = index.find("2024/report.csv")) ...
+        index.refresh(); // Catch up with changes on disk
+    */
+    Folder root;
+    std::unordered_map<str_t, stdfs::file_type> entries; // Relative path -> type
+    int inotifyFd = -1;
+    std::unordered_map<int, str_t> watches; // Watch descriptor -> relative directory ("" = root)
+    bool watchedFully = true; // False once a directory couldn't be watched (e.g. max_user_watches hit)
+
+
+    explicit FolderIndex(Folder root_) : root(std::move(root_)) {
+      #ifdef __linux__
+        inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+      #endif
+      rebuild();
+    }
+    ~FolderIndex() noexcept {
+      #ifndef _WIN32
+        if (inotifyFd != -1)
+          ::close(inotifyFd);
+      #endif
+    }
+    FolderIndex(const FolderIndex&) = delete;
+    FolderIndex& operator=(const FolderIndex&) = delete;
+
+
+    size_t size() const noexcept { return entries.size(); }
+    bool is_watching() const noexcept { return inotifyFd != -1 && watchedFully; }
+    std::optional<Road> find(strv_t relative) const {
+      /*
+        Same as Folder::find but answered from memory
+      */
+      if (relative.empty())
+        throw std::invalid_argument("Name is empty");
+      const str_t key = normalized(relative);
+      if (!entries.contains(key))
+        return std::nullopt;
+      Road road;
+      road.isAt = root.isAt / key;
+      return road;
+    }
+    std::optional<stdfs::file_type> type_of(strv_t relative) const {
+      const auto it = entries.find(normalized(relative));
+      if (it == entries.end())
+        return std::nullopt;
+      return it->second;
+    }
+
+
+    void rebuild() {
+      entries.clear();
+      #ifdef __linux__
+        for (const auto& [wd, _] : watches)
+          ::inotify_rm_watch(inotifyFd, wd);
+        watches.clear();
+        if (inotifyFd != -1)
+          (void)inotify_read_all_pending(); // Events from before are stale now
+      #endif
+      watchedFully = true;
+      add_tree("");
+    }
+    void refresh() {
+      /*
+        Apply every change on disk since the last
+        refresh (or rebuild if changes can't be tracked)
+      */
+      #ifdef __linux__
+        if (!is_watching())
+          return rebuild(); // Changes in unwatched directories would be missed
+        const std::vector<char> events = inotify_read_all_pending();
+        for (size_t at = 0; at + sizeof(inotify_event) <= events.size();) {
+          inotify_event event;
+          std::memcpy(&event, events.data() + at, sizeof(event));
+          const str_t name = event.len > 0 ? str_t(events.data() + at + sizeof(event)) : str_t();
+          at += sizeof(inotify_event) + event.len;
+          if (event.mask & IN_Q_OVERFLOW)
+            return rebuild(); // Lost track
+          const auto source = watches.find(event.wd);
+          if (source == watches.end())
+            continue;
+          if (event.mask & IN_IGNORED) {
+            watches.erase(source);
+            continue;
+          }
+          if (name.empty())
+            continue;
+          const str_t relative = source->second.empty() ? name : source->second + PATH_SEPARATOR + name;
+          if (event.mask & (IN_DELETE | IN_MOVED_FROM))
+            remove_tree(relative);
+          if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+            std::error_code ec;
+            const stdfs::file_type type = stdfs::symlink_status(root.isAt / relative, ec).type();
+            if (ec)
+              continue; // Already gone again
+            entries[relative] = type;
+            if (type == stdfs::file_type::directory)
+              add_tree(relative);
+          }
+        }
+      #else
+        rebuild();
+      #endif
+    }
+
+
+    str_t normalized(strv_t relative) const {
+      str_t key = stdfs::path(relative).lexically_normal().string();
+      while (!key.empty() && key.back() == PATH_SEPARATOR)
+        key.pop_back();
+      return key;
+    }
+    void add_tree(const str_t& relative) {
+      // Index (and watch) everything below `relative`
+      const Folder top = relative.empty() ? root : Folder(root.isAt / relative);
+      const str_t rootStr = root.isAt.string();
+      const size_t cut = rootStr.size() + (rootStr.ends_with(PATH_SEPARATOR) ? 0 : 1); // Keeps the relative part only
+      watch(relative);
+      top.walk([&](const stdfs::directory_entry& entry, size_t) {
+        // walk() serializes the calls
+        const str_t key = entry.path().string().substr(cut);
+        const stdfs::file_type type = cached_type(entry);
+        entries[key] = type;
+        if (type == stdfs::file_type::directory)
+          watch(key);
+      });
+    }
+    static stdfs::file_type cached_type(const stdfs::directory_entry& entry) noexcept {
+      // Prefer the type the directory listing came with over another lstat
+      std::error_code ec;
+      if (entry.is_symlink(ec))
+        return stdfs::file_type::symlink;
+      if (entry.is_directory(ec))
+        return stdfs::file_type::directory;
+      if (entry.is_regular_file(ec))
+        return stdfs::file_type::regular;
+      return entry.symlink_status(ec).type();
+    }
+    void remove_tree(const str_t& relative) {
+      entries.erase(relative);
+      const str_t below = relative + PATH_SEPARATOR;
+      std::erase_if(entries, [&below](const auto& entry) { return entry.first.starts_with(below); });
+      #ifdef __linux__
+        for (auto it = watches.begin(); it != watches.end();)
+          if (it->second == relative || it->second.starts_with(below)) {
+            ::inotify_rm_watch(inotifyFd, it->first);
+            it = watches.erase(it);
+          }
+          else
+            ++it;
+      #endif
+    }
+    void watch([[maybe_unused]] const str_t& relative) {
+      #ifdef __linux__
+        if (inotifyFd == -1)
+          return;
+        const int wd = ::inotify_add_watch(inotifyFd, (root.isAt / relative).c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW);
+        if (wd != -1)
+          watches[wd] = relative;
+        else if (errno != ENOENT && errno != ENOTDIR) // Those are just gone again
+          watchedFully = false;
+      #endif
+    }
+    #ifdef __linux__
+    std::vector<char> inotify_read_all_pending() const {
+      std::vector<char> events;
+      std::array<char, 64 * 1024> buffer;
+      while (true) {
+        const ssize_t got = ::read(inotifyFd, buffer.data(), buffer.size());
+        if (got <= 0 && errno == EINTR)
+          continue;
+        if (got <= 0)
+          return events; // EAGAIN: nothing left
+        events.insert(events.end(), buffer.data(), buffer.data() + got);
+      }
+    }
+    #endif
+  };
+
+
+
   str_t scramble_name(size_t len = 64 /*~59^n possible combinations*/ ) noexcept {
     /*
       Generate a random filename with a length of `len`
@@ -881,18 +2904,634 @@ namespace cslib {
 
 
 
+  #ifndef _WIN32
+  struct HttpResponse {
+    int status = 0;
+    str_t reason;
+    std::vector<std::pair<str_t, str_t>> headers; // Names in lowercase
+    str_t body;
+
+
+    std::optional<strv_t> header(strv_t name) const noexcept {
+      // Case insensitive lookup of the first header called `name`
+      const auto lower = [](char c) { return char(std::tolower((unsigned char)c)); };
+      for (const auto& [key, value] : headers)
+        if (std::ranges::equal(key, name, {}, lower, lower))
+          return value;
+      return std::nullopt;
+    }
+  };
+
+
+
+  struct HttpUrl {
+    /*
+      The parts of a plain "http://" URL that are
+      needed to send a request.
+    */
+    str_t host;
+    str_t port = "80";
+    str_t target = "/";
+
+
+    static std::optional<HttpUrl> parse(strv_t url) noexcept {
+      if (!url.starts_with("http://"))
+        return std::nullopt;
+      url.remove_prefix(7);
+      const size_t authorityEnd = url.find_first_of("/?#");
+      strv_t authority = url.substr(0, authorityEnd);
+      if (authority.contains('@'))
+        return std::nullopt; // No credentials
+      HttpUrl parsed;
+      if (authorityEnd != strv_t::npos) {
+        strv_t target = url.substr(authorityEnd);
+        target = target.substr(0, target.find('#'));
+        parsed.target = target.starts_with('/') ? str_t(target) : '/' + str_t(target);
+      }
+      if (authority.starts_with('[')) { // IPv6 literal
+        const size_t close = authority.find(']');
+        if (close == strv_t::npos)
+          return std::nullopt;
+        parsed.host = str_t(authority.substr(1, close - 1));
+        authority.remove_prefix(close + 1);
+        if (!authority.empty() && !authority.starts_with(':'))
+          return std::nullopt;
+        if (authority.size() > 1)
+          parsed.port = str_t(authority.substr(1));
+      }
+      else {
+        const size_t colon = authority.find(':');
+        parsed.host = str_t(authority.substr(0, colon));
+        if (colon != strv_t::npos && colon + 1 < authority.size())
+          parsed.port = str_t(authority.substr(colon + 1));
+      }
+      if (parsed.host.empty() || !std::ranges::all_of(parsed.port, [](char c) { return c >= '0' && c <= '9'; }))
+        return std::nullopt;
+      return parsed;
+    }
+    str_t key() const { return host + ':' + port; }
+    str_t host_header() const {
+      const str_t name = host.contains(':') ? '[' + host + ']' : host;
+      return port == "80" ? name : name + ':' + port;
+    }
+    std::optional<HttpUrl> resolve(strv_t location) const noexcept {
+      // Where a redirect's Location header points to
+      if (location.starts_with("http://") || location.starts_with("https://"))
+        return parse(location);
+      if (location.starts_with("//"))
+        return parse("http:" + str_t(location));
+      HttpUrl next = *this;
+      if (location.starts_with('/'))
+        next.target = str_t(location);
+      else
+        next.target = target.substr(0, target.rfind('/') + 1) + str_t(location);
+      return next;
+    }
+  };
+
+
+
+  class HttpClient { public:
+    /*
+      Plain HTTP/1.1 client on sockets. Connections are
+      kept alive and reused per host, optionally with
+      several requests pipelined on each, and many URLs
+      are fetched concurrently from a single poll() loop.
+      Note:
+        Only "http://" GET requests; TLS isn't
+        supported. Redirects are followed, except to
+        other schemes, where the 3xx response itself
+        is the result.
+      Example:
+        cslib::HttpClient client;
+        client.pipelineDepth = 4;
+        auto pages = client.fetch_all(urls, 8);
+        if (pages.at(0) && pages.at(0)->status == 200)
+          std::cout << pages.at(0)->body;
+    */
+    struct Connection {
+      int fd = -1;
+      str_t key;
+
+      Connection(int fd_, str_t key_) noexcept : fd(fd_), key(std::move(key_)) {}
+      ~Connection() noexcept {
+        if (fd != -1)
+          ::close(fd);
+      }
+      Connection(Connection&& other) noexcept : fd(std::exchange(other.fd, -1)), key(std::move(other.key)) {}
+      Connection& operator=(Connection&& other) noexcept {
+        if (this != &other) {
+          if (fd != -1)
+            ::close(fd);
+          fd = std::exchange(other.fd, -1);
+          key = std::move(other.key);
+        }
+        return *this;
+      }
+    };
+    using result_t = std::expected<HttpResponse, str_t>;
+    using address_t = std::pair<sockaddr_storage, socklen_t>;
+    struct Resolved {
+      std::vector<address_t> addresses; // In getaddrinfo's order, tried one after another
+      std::chrono::steady_clock::time_point expires;
+    };
+    struct ResponseParser {
+      // Where parse_response stopped, so more data resumes there instead of at byte 0
+      HttpResponse response = {};
+      bool keepAlive = true;
+      size_t offset = 0; // Start of the response, after interim 1xx ones
+      size_t scanned = 0; // Searched for the end of the headers up to here
+      size_t bodyStart = 0; // 0 until the headers are complete
+      bool chunked = false;
+      size_t at = 0; // Chunked: next chunk size (or trailer) line
+      bool trailers = false; // Chunked: past the last chunk
+    };
+
+    size_t pipelineDepth = 1; // Requests sent ahead on one connection
+    size_t maxIdlePerHost = 8; // Connections kept alive for later
+    size_t maxRedirects = 20;
+    std::chrono::milliseconds timeout = std::chrono::seconds(30); // Without progress on a connection
+    std::chrono::seconds resolveTtl = std::chrono::seconds(60); // How long host lookups are reused
+    std::mutex lock; // Guards idle and resolved
+    std::unordered_map<str_t, std::vector<Connection>> idle;
+    std::unordered_map<str_t, Resolved> resolved;
+
+
+    static HttpClient& shared() {
+      static HttpClient client;
+      return client;
+    }
+
+
+    result_t fetch(const str_t& url) {
+      return fetch_all(std::span<const str_t>(&url, 1), 1).front();
+    }
+
+
+    std::vector<result_t> fetch_all(std::span<const str_t> urls, size_t maxConnections = 8) {
+      /*
+        Fetch every URL with at most `maxConnections`
+        sockets open at a time. Results keep the order
+        of `urls`.
+      */
+      struct Job {
+        size_t index;
+        HttpUrl url;
+        size_t redirects = 0;
+        bool retried = false;
+      };
+      struct Active {
+        Connection connection;
+        std::deque<Job> inFlight = {};
+        str_t outgoing = {};
+        size_t sent = 0;
+        str_t incoming = {};
+        ResponseParser parser = {}; // For the front of `incoming`
+        bool connecting = false;
+        bool reused = false;
+        bool answered = false; // Got at least one response
+        bool done = false;
+        std::vector<address_t> addresses = {}; // Left to try if connecting fails
+        size_t nextAddress = 0;
+        std::chrono::steady_clock::time_point deadline = {};
+      };
+
+      std::vector<result_t> results(urls.size(), std::unexpected(str_t("Not fetched")));
+      std::deque<Job> pending;
+      for (size_t i = 0; i < urls.size(); ++i)
+        if (std::optional<HttpUrl> url = HttpUrl::parse(urls[i]))
+          pending.push_back(Job{i, std::move(*url)});
+        else
+          results.at(i) = std::unexpected("Unsupported URL '" + urls[i] + "'");
+      if (maxConnections == 0)
+        maxConnections = 1;
+
+      const auto request_of = [](const HttpUrl& url) {
+        return "GET " + url.target + " HTTP/1.1\r\nHost: " + url.host_header() +
+          "\r\nUser-Agent: cslib\r\nAccept: */*\r\nConnection: keep-alive\r\n\r\n";
+      };
+      const auto fail_all = [&](Active& active, const str_t& why) {
+        for (const Job& job : active.inFlight)
+          results.at(job.index) = std::unexpected(why);
+        active.inFlight.clear();
+        active.done = true;
+      };
+      const auto requeue_all = [&](Active& active) {
+        /*
+          GETs are idempotent, so unanswered requests go
+          to a new connection. Either this connection made
+          progress or each job gets one retry, so it ends.
+        */
+        if (!active.answered && active.inFlight.front().retried)
+          return fail_all(active, "Connection closed before the response was complete");
+        for (Job& job : active.inFlight | std::views::reverse) {
+          job.retried = job.retried || !active.answered;
+          pending.push_front(std::move(job));
+        }
+        active.inFlight.clear();
+        active.done = true;
+      };
+      const auto connect_next = [&](Active& active) -> bool {
+        // Start connecting to the next address left, false if there's none
+        while (active.nextAddress < active.addresses.size()) {
+          std::expected<Connection, str_t> opened = connect_to(active.addresses.at(active.nextAddress++), active.connection.key);
+          if (opened) {
+            active.connection = std::move(*opened);
+            active.connecting = true;
+            return true;
+          }
+        }
+        return false;
+      };
+      const auto complete = [&](Job& job, HttpResponse&& response) {
+        const std::optional<strv_t> location = response.header("location");
+        if (response.status >= 300 && response.status < 400 && response.status != 304 && location && job.redirects < maxRedirects)
+          if (std::optional<HttpUrl> next = job.url.resolve(*location)) {
+            pending.push_front(Job{job.index, std::move(*next), job.redirects + 1});
+            return;
+          }
+        results.at(job.index) = std::move(response); // Includes redirects elsewhere (like https://)
+      };
+
+      // Look up all hosts at once on the pool, so the loop below rarely waits for DNS
+      std::vector<std::future<void>> lookups;
+      std::unordered_map<str_t, const HttpUrl*> hosts;
+      for (const Job& job : pending)
+        hosts.try_emplace(job.url.key(), &job.url);
+      if (hosts.size() > 1)
+        for (const auto& [_, url] : hosts)
+          lookups.push_back(ThreadPool::shared().submit([this, url] { (void)resolve(*url); }));
+      for (std::future<void>& lookup : lookups)
+        ThreadPool::shared().get(lookup);
+
+      std::vector<Active> active;
+      std::vector<pollfd> polled;
+      std::vector<char> buffer(size_t(64 * 1024));
+      while (!pending.empty() || !active.empty()) {
+        while (active.size() < maxConnections && !pending.empty()) {
+          Job job = std::move(pending.front());
+          pending.pop_front();
+          const str_t key = job.url.key();
+          std::optional<Connection> reused = take_idle(key);
+          std::vector<address_t> addresses;
+          if (!reused) {
+            std::expected<std::vector<address_t>, str_t> found = resolve(job.url);
+            if (!found) {
+              results.at(job.index) = std::unexpected(std::move(found.error()));
+              continue;
+            }
+            addresses = std::move(*found);
+          }
+          Active& slot = active.emplace_back(Active{.connection = reused ? std::move(*reused) : Connection(-1, key)});
+          slot.reused = reused.has_value();
+          slot.addresses = std::move(addresses);
+          if (!slot.reused && !connect_next(slot)) {
+            forget(key);
+            results.at(job.index) = std::unexpected("Failed to connect to '" + key + "': " + std::strerror(errno));
+            active.pop_back();
+            continue;
+          }
+          slot.deadline = std::chrono::steady_clock::now() + timeout;
+          slot.outgoing = request_of(job.url);
+          slot.inFlight.push_back(std::move(job));
+          for (auto it = pending.begin(); it != pending.end() && slot.inFlight.size() < pipelineDepth;)
+            if (it->url.key() == key) {
+              slot.outgoing += request_of(it->url);
+              slot.inFlight.push_back(std::move(*it));
+              it = pending.erase(it);
+            }
+            else
+              ++it;
+        }
+        if (active.empty())
+          continue;
+
+        polled.clear();
+        auto wakeUp = active.front().deadline;
+        for (const Active& slot : active) {
+          const bool writing = slot.connecting || slot.sent < slot.outgoing.size();
+          polled.push_back(pollfd{slot.connection.fd, short(POLLIN | (writing ? POLLOUT : 0)), 0});
+          wakeUp = std::min(wakeUp, slot.deadline);
+        }
+        const auto waitMs = std::chrono::ceil<std::chrono::milliseconds>(wakeUp - std::chrono::steady_clock::now()).count();
+        if (::poll(polled.data(), polled.size(), int(std::clamp<int64_t>(waitMs, 0, 60'000))) == -1 && errno != EINTR)
+          throw std::runtime_error(str_t("poll failed in HttpClient: ") + std::strerror(errno));
+
+        const auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < active.size(); ++i) {
+          Active& slot = active.at(i);
+          const short events = polled.at(i).revents;
+          if (events == 0) {
+            if (now >= slot.deadline)
+              fail_all(slot, "Timed out");
+            continue;
+          }
+          if (slot.connecting) {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            ::getsockopt(slot.connection.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            if (error != 0) {
+              if (!connect_next(slot)) { // Try the next address (say IPv4 after ::1)
+                forget(slot.connection.key);
+                fail_all(slot, "Failed to connect to '" + slot.connection.key + "': " + std::strerror(error));
+              }
+              continue;
+            }
+            slot.connecting = false;
+          }
+          while (slot.sent < slot.outgoing.size()) {
+            const ssize_t sent = ::send(slot.connection.fd, slot.outgoing.data() + slot.sent, slot.outgoing.size() - slot.sent, MSG_NOSIGNAL);
+            if (sent > 0)
+              slot.sent += size_t(sent);
+            else if (sent < 0 && errno == EINTR)
+              continue;
+            else
+              break; // Full or broken, reading tells which
+          }
+
+          bool closed = false;
+          while (true) {
+            const ssize_t got = ::recv(slot.connection.fd, buffer.data(), buffer.size(), 0);
+            if (got > 0) {
+              slot.incoming.append(buffer.data(), size_t(got));
+              slot.deadline = now + timeout;
+              continue;
+            }
+            if (got < 0 && errno == EINTR)
+              continue;
+            closed = got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+            break;
+          }
+
+          bool keepAlive = true;
+          try {
+            while (!slot.inFlight.empty() && keepAlive) {
+              const std::optional<size_t> used = parse_response(slot.incoming, closed, slot.parser);
+              if (!used)
+                break;
+              ResponseParser parsed = std::exchange(slot.parser, ResponseParser{});
+              keepAlive = parsed.keepAlive;
+              slot.incoming.erase(0, *used);
+              slot.answered = true;
+              Job job = std::move(slot.inFlight.front());
+              slot.inFlight.pop_front();
+              complete(job, std::move(parsed.response));
+            }
+          }
+          catch (const std::exception& e) {
+            fail_all(slot, e.what());
+            continue;
+          }
+          if (!keepAlive || closed) {
+            // Servers may close after any response, with or without saying so
+            if (slot.inFlight.empty())
+              slot.done = true;
+            else
+              requeue_all(slot);
+            continue;
+          }
+          if (slot.inFlight.empty()) {
+            slot.done = true;
+            if (slot.incoming.empty())
+              release(std::move(slot.connection));
+          }
+        }
+        std::erase_if(active, [](const Active& slot) { return slot.done; });
+      }
+      return results;
+    }
+
+
+    static std::optional<size_t> parse_response(strv_t data, bool closed, ResponseParser& state) {
+      /*
+        Parse the response at the front of `data` and
+        return how many bytes it took, or std::nullopt
+        if it isn't complete yet. Called again once more
+        data was appended, it continues from `state`, so
+        a large body is only looked at once. The result
+        is in state.response and state.keepAlive.
+        Interim 1xx responses are skipped.
+      */
+      HttpResponse& response = state.response;
+      while (state.bodyStart == 0) {
+        const size_t headEnd = data.find("\r\n\r\n", std::max(state.offset, state.scanned));
+        if (headEnd == strv_t::npos) {
+          if (data.size() - state.offset > 64 * 1024)
+            throw std::runtime_error("HTTP response headers too large");
+          state.scanned = std::max(state.offset, data.size() - std::min<size_t>(data.size(), 3)); // "\r\n\r" may be split
+          return std::nullopt;
+        }
+        const strv_t head = data.substr(state.offset, headEnd - state.offset);
+
+        const size_t lineEnd = std::min(head.find("\r\n"), head.size());
+        const strv_t statusLine = head.substr(0, lineEnd);
+        int status = 0;
+        if (statusLine.size() < 12 || !statusLine.starts_with("HTTP/1.") ||
+            std::from_chars(statusLine.data() + 9, statusLine.data() + 12, status).ec != std::errc())
+          throw std::runtime_error("Malformed HTTP status line '" + str_t(statusLine) + "'");
+        if (status >= 100 && status < 200) {
+          state.offset = state.scanned = headEnd + 4;
+          continue;
+        }
+
+        response = HttpResponse{};
+        response.status = status;
+        response.reason = statusLine.size() > 13 ? str_t(statusLine.substr(13)) : "";
+        for (size_t at = lineEnd + 2; at < head.size();) {
+          const size_t end = std::min(head.find("\r\n", at), head.size());
+          const strv_t line = head.substr(at, end - at);
+          at = end + 2;
+          const size_t colon = line.find(':');
+          if (colon == strv_t::npos)
+            continue;
+          str_t name(line.substr(0, colon));
+          std::ranges::transform(name, name.begin(), [](char c) { return char(std::tolower((unsigned char)c)); });
+          strv_t value = line.substr(colon + 1);
+          value.remove_prefix(std::min(value.find_first_not_of(" \t"), value.size()));
+          value.remove_suffix(value.size() - (value.find_last_not_of(" \t") + 1));
+          response.headers.emplace_back(std::move(name), str_t(value));
+        }
+
+        const str_t connection = [&] {
+          str_t value(response.header("connection").value_or(""));
+          std::ranges::transform(value, value.begin(), [](char c) { return char(std::tolower((unsigned char)c)); });
+          return value;
+        }();
+        state.keepAlive = statusLine[7] == '0' ? connection.contains("keep-alive") : !connection.contains("close");
+        state.chunked = response.header("transfer-encoding").value_or("").contains("chunked");
+        state.bodyStart = state.at = headEnd + 4;
+      }
+
+      if (state.chunked) {
+        // Complete chunks are decoded right away, state.at is the first byte not decoded yet
+        while (!state.trailers) {
+          const size_t sizeEnd = data.find("\r\n", state.at);
+          if (sizeEnd == strv_t::npos)
+            return std::nullopt;
+          size_t chunkSize = 0;
+          if (std::from_chars(data.data() + state.at, data.data() + sizeEnd, chunkSize, 16).ec != std::errc())
+            throw std::runtime_error("Malformed HTTP chunk size");
+          if (chunkSize == 0) {
+            state.trailers = true;
+            state.at = sizeEnd + 2;
+            break;
+          }
+          if (data.size() < sizeEnd + 2 + chunkSize + 2)
+            return std::nullopt;
+          response.body.append(data.substr(sizeEnd + 2, chunkSize));
+          state.at = sizeEnd + 2 + chunkSize + 2;
+        }
+        while (true) { // Trailers
+          const size_t trailerEnd = data.find("\r\n", state.at);
+          if (trailerEnd == strv_t::npos)
+            return std::nullopt;
+          const bool last = trailerEnd == state.at;
+          state.at = trailerEnd + 2;
+          if (last)
+            return state.at;
+        }
+      }
+      if (const std::optional<strv_t> lengthHeader = response.header("content-length")) {
+        size_t length = 0;
+        if (std::from_chars(lengthHeader->data(), lengthHeader->data() + lengthHeader->size(), length).ec != std::errc())
+          throw std::runtime_error("Malformed Content-Length '" + str_t(*lengthHeader) + "'");
+        if (data.size() - state.bodyStart < length)
+          return std::nullopt;
+        response.body = str_t(data.substr(state.bodyStart, length));
+        return state.bodyStart + length;
+      }
+      if (response.status == 204 || response.status == 304)
+        return state.bodyStart;
+      // Body ends with the connection
+      if (!closed)
+        return std::nullopt;
+      state.keepAlive = false;
+      response.body = str_t(data.substr(state.bodyStart));
+      return data.size();
+    }
+
+
+    std::optional<Connection> take_idle(const str_t& key) noexcept {
+      // A pooled connection that the server hasn't closed yet
+      std::lock_guard guard(lock);
+      auto found = idle.find(key);
+      if (found == idle.end())
+        return std::nullopt;
+      std::vector<Connection>& connections = found->second;
+      while (!connections.empty()) {
+        Connection connection = std::move(connections.back());
+        connections.pop_back();
+        char probe;
+        if (::recv(connection.fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT) == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+          return connection;
+      }
+      return std::nullopt;
+    }
+    void release(Connection&& connection) {
+      std::lock_guard guard(lock);
+      std::vector<Connection>& connections = idle[connection.key];
+      if (connections.size() < maxIdlePerHost)
+        connections.push_back(std::move(connection));
+    }
+
+
+    std::expected<std::vector<address_t>, str_t> resolve(const HttpUrl& url) {
+      /*
+        Every address of the host (cached for resolveTtl).
+        getaddrinfo blocks, which is why fetch_all looks
+        hosts up ahead of its poll loop.
+      */
+      const str_t key = url.key();
+      {
+        std::lock_guard guard(lock);
+        const auto cached = resolved.find(key);
+        if (cached != resolved.end() && std::chrono::steady_clock::now() < cached->second.expires)
+          return cached->second.addresses;
+      }
+      addrinfo hints{};
+      hints.ai_family = AF_UNSPEC;
+      hints.ai_socktype = SOCK_STREAM;
+      addrinfo* found = nullptr;
+      if (const int error = ::getaddrinfo(url.host.c_str(), url.port.c_str(), &hints, &found); error != 0)
+        return std::unexpected("Failed to resolve '" + url.host + "': " + ::gai_strerror(error));
+      Resolved entry;
+      for (const addrinfo* info = found; info != nullptr; info = info->ai_next) {
+        address_t address{};
+        std::memcpy(&address.first, info->ai_addr, info->ai_addrlen);
+        address.second = info->ai_addrlen;
+        entry.addresses.push_back(address);
+      }
+      ::freeaddrinfo(found);
+      entry.expires = std::chrono::steady_clock::now() + resolveTtl;
+      std::lock_guard guard(lock);
+      return (resolved[key] = std::move(entry)).addresses;
+    }
+    void forget(const str_t& key) {
+      // None of the addresses worked, look them up again next time
+      std::lock_guard guard(lock);
+      resolved.erase(key);
+    }
+
+
+    static std::expected<Connection, str_t> connect_to(const address_t& address, const str_t& key) {
+      // Non-blocking connect, finished inside the poll loop
+      const auto& [storage, length] = address;
+      Connection connection(::socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0), key);
+      if (connection.fd == -1)
+        return std::unexpected(str_t("Failed to create socket: ") + std::strerror(errno));
+      const int noDelay = 1;
+      ::setsockopt(connection.fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+      if (::connect(connection.fd, reinterpret_cast<const sockaddr*>(&storage), length) == -1 && errno != EINPROGRESS)
+        return std::unexpected("Failed to connect to '" + key + "': " + std::strerror(errno));
+      return connection;
+    }
+  };
+  #endif
+
+
+
   std::expected<str_t, int> get(str_t url, str_t params = "-fsSL") noexcept {
     /*
       Download the content of the given URL using wget
       and return it as a string. If the download fails,
       an error code will be returned.
       Note:
-        This function requires curl to be installed
+        Plain "http://" URLs with the default params
+        are fetched in-process by HttpClient::shared()
+        (keeping its connections alive). Errors then
+        use curl's codes (22 for HTTP >= 400, 7 when
+        there was no response) as sh_call reports them.
+        Everything else, including redirects to https
+        and any proxy set in the environment, goes
+        through curl, which has to be installed
       Important note:
         Just like the sh_call function itself, this
         function is VERY injection prone. No direct
         user input recommended
     */
+    #ifndef _WIN32
+      const bool proxied = std::ranges::any_of(std::array{"http_proxy", "all_proxy", "ALL_PROXY"}, [](const char* name) {
+        const char* value = std::getenv(name);
+        return value != nullptr && *value != '\0';
+      });
+      if (params == "-fsSL" && url.starts_with("http://") && !proxied) {
+        try {
+          HttpClient::result_t response = HttpClient::shared().fetch(url);
+          if (!response)
+            return std::unexpected(7 << 8);
+          const bool redirectedAway = response->status >= 300 && response->status < 400 && response->header("location");
+          if (!redirectedAway) {
+            if (response->status >= 400)
+              return std::unexpected(22 << 8);
+            return std::move(response->body);
+          }
+          // Left http:// (most likely for https://), curl takes it from here
+        }
+        catch (...) {
+          return std::unexpected(-1);
+        }
+      }
+    #endif
     return sh_call("curl " + params + " " + url); 
   }
 
@@ -958,6 +3597,144 @@ namespace cslib {
     */
     return std::async(std::launch::async, std::forward<F>(f), std::forward<Args>(args)...);
   }
+  template <typename F, typename... Args>
+  requires (std::is_invocable_v<F, Args...>)
+  [[nodiscard]] std::future<std::invoke_result_t<F, Args...>> do_in_parallel(ThreadPool& pool, F&& f, Args&&... args) {
+    /*
+      Opt-in path that runs the task on a (reused) pool
+      worker instead of spawning a new thread.
+      Note:
+        Unlike std::async's future, this one does not
+        block upon destruction.
+      Example:
+        std::future<int> fut = do_in_parallel(cslib::ThreadPool::shared(), [] { return 42; });
+    */
+    return pool.submit(std::forward<F>(f), std::forward<Args>(args)...);
+  }
+
+
+
+  template <typename R, typename F>
+  requires (std::ranges::random_access_range<R> && std::ranges::sized_range<R>)
+  auto parallel_chunks(R&& items, ThreadPool& pool, F&& onChunk) {
+    /*
+      Split `items` into a few chunks per worker, run
+      `onChunk(begin, end)` for each of them on `pool`
+      and collect the results in order.
+    */
+    using chunk_result_t = std::invoke_result_t<F&, size_t, size_t>;
+    const size_t total = std::ranges::size(items);
+    const size_t chunkCount = std::min(total, pool.size() * 4);
+    std::vector<std::future<chunk_result_t>> futures;
+    futures.reserve(chunkCount);
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+      futures.emplace_back(pool.submit([&onChunk, begin = total * chunk / chunkCount, end = total * (chunk + 1) / chunkCount] {
+        return onChunk(begin, end);
+      }));
+    // Wait for all of them before rethrowing, chunks still reference `items`
+    for (std::future<chunk_result_t>& future : futures)
+      while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        if (!pool.run_pending_task())
+          std::this_thread::yield();
+    if constexpr (std::is_void_v<chunk_result_t>) {
+      for (std::future<chunk_result_t>& future : futures)
+        future.get();
+    }
+    else {
+      std::vector<chunk_result_t> results;
+      results.reserve(futures.size());
+      for (std::future<chunk_result_t>& future : futures)
+        results.emplace_back(future.get());
+      return results;
+    }
+  }
+
+
+  template <typename R, typename F>
+  requires (std::ranges::random_access_range<R> && std::invocable<F&, std::ranges::range_reference_t<R>>)
+  void parallel_for(R&& items, F&& f, ThreadPool& pool = ThreadPool::shared()) {
+    /*
+      Call `f` on every element of `items` using the
+      pool. Safe to nest.
+      Example:
+        cslib::parallel_for(cslib::range(100), [](int i) { ... });
+    */
+    parallel_chunks(items, pool, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+        std::invoke(f, std::ranges::begin(items)[i]);
+    });
+  }
+
+
+  template <typename R, typename F>
+  requires (std::ranges::random_access_range<R> && std::invocable<F&, std::ranges::range_reference_t<R>>)
+  auto parallel_map(R&& items, F&& f, ThreadPool& pool = ThreadPool::shared()) {
+    /*
+      Example:
+        std::vector<int> squares = cslib::parallel_map(cslib::range(10), [](int i) { return i * i; });
+    */
+    using mapped_t = std::decay_t<std::invoke_result_t<F&, std::ranges::range_reference_t<R>>>;
+    std::vector<std::vector<mapped_t>> parts = parallel_chunks(items, pool, [&](size_t begin, size_t end) {
+      std::vector<mapped_t> part;
+      part.reserve(end - begin);
+      for (size_t i = begin; i < end; ++i)
+        part.emplace_back(std::invoke(f, std::ranges::begin(items)[i]));
+      return part;
+    });
+    std::vector<mapped_t> result;
+    result.reserve(std::ranges::size(items));
+    for (std::vector<mapped_t>& part : parts)
+      std::ranges::move(part, std::back_inserter(result));
+    return result;
+  }
+
+
+  template <typename R, typename T, typename Op, typename Transform>
+  requires (std::ranges::random_access_range<R> && std::invocable<Transform&, std::ranges::range_reference_t<R>> &&
+    std::invocable<Op&, T, T> && std::convertible_to<std::invoke_result_t<Op&, T, T>, T> &&
+    std::convertible_to<std::invoke_result_t<Transform&, std::ranges::range_reference_t<R>>, T>)
+  T parallel_reduce(R&& items, T init, Op&& op, Transform&& transform, ThreadPool& pool = ThreadPool::shared()) {
+    /*
+      Like std::transform_reduce: every item is turned
+      into a T by `transform`, then all of them and
+      `init` are combined with `op(T, T)`.
+      Note:
+        `op` has to be associative because chunks are
+        combined independently (but in order) first
+      Example:
+        long squares = cslib::parallel_reduce(cslib::range(1000), 0L, std::plus<>(), [](int x) { return long(x) * x; });
+    */
+    std::vector<std::optional<T>> parts = parallel_chunks(items, pool, [&](size_t begin, size_t end) {
+      std::optional<T> part;
+      for (size_t i = begin; i < end; ++i) {
+        T item = std::invoke(transform, std::ranges::begin(items)[i]);
+        part = part ? T(std::invoke(op, std::move(*part), std::move(item))) : std::move(item);
+      }
+      return part;
+    });
+    for (std::optional<T>& part : parts)
+      if (part)
+        init = std::invoke(op, std::move(init), std::move(*part));
+    return init;
+  }
+  template <typename R, typename T, typename Op>
+  requires (std::ranges::random_access_range<R> && std::convertible_to<std::ranges::range_reference_t<R>, T> &&
+    std::invocable<Op&, T, T> && std::convertible_to<std::invoke_result_t<Op&, T, T>, T>)
+  T parallel_reduce(R&& items, T init, Op&& op, ThreadPool& pool = ThreadPool::shared()) {
+    /*
+      Like std::reduce: combine `items` (converted to T)
+      and `init` with `op(T, T)`.
+      Note:
+        `op` has to be associative and take two T,
+        since it also merges the results of chunks.
+        For "accumulator += f(item)" style folds, pass
+        f as transform to the overload above
+      Example:
+        int sum = cslib::parallel_reduce(cslib::range(100), 0, std::plus<>());
+    */
+    return parallel_reduce(std::forward<R>(items), std::move(init), std::forward<Op>(op),
+      [](std::ranges::range_reference_t<R> item) { return T(item); }, pool);
+  }
 
 
 
@@ -970,38 +3747,85 @@ namespace cslib {
 
 
 
-  str_t common_prefix(std::vector<str_t> strs) noexcept { // TODO make more readable
+  inline size_t common_prefix_length(const char* a, const char* b, size_t length) noexcept {
+    // How many leading bytes of `a` and `b` are equal (looking at `length` at most)
+    size_t i = 0;
+    #ifdef __AVX2__
+      for (; i + 32 <= length; i += 32) {
+        const __m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        if (const uint32_t differ = ~uint32_t(_mm256_movemask_epi8(equal)); differ != 0)
+          return i + std::countr_zero(differ);
+      }
+    #endif
+    #ifdef __SSE2__
+      for (; i + 16 <= length; i += 16) {
+        const __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        if (const uint32_t differ = ~uint32_t(_mm_movemask_epi8(equal)) & 0xFFFF; differ != 0)
+          return i + std::countr_zero(differ);
+      }
+    #endif
+    while (i < length && a[i] == b[i])
+      ++i;
+    return i;
+  }
+  inline size_t common_suffix_length(const char* aEnd, const char* bEnd, size_t length) noexcept {
+    // Same as common_prefix_length but walking backwards from the ends
+    size_t i = 0;
+    #ifdef __AVX2__
+      for (; i + 32 <= length; i += 32) {
+        const __m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(aEnd - i - 32)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bEnd - i - 32)));
+        if (const uint32_t differ = ~uint32_t(_mm256_movemask_epi8(equal)); differ != 0)
+          return i + std::countl_zero(differ);
+      }
+    #endif
+    #ifdef __SSE2__
+      for (; i + 16 <= length; i += 16) {
+        const __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(aEnd - i - 16)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(bEnd - i - 16)));
+        if (const uint32_t differ = ~uint32_t(_mm_movemask_epi8(equal)) & 0xFFFF; differ != 0)
+          return i + std::countl_zero(differ) - 16; // Only the lower 16 bits are used
+      }
+    #endif
+    while (i < length && aEnd[-1 - std::ptrdiff_t(i)] == bEnd[-1 - std::ptrdiff_t(i)])
+      ++i;
+    return i;
+  }
+
+
+  inline strv_t common_prefix(std::span<const strv_t> strs) noexcept {
+    /*
+      Example:
+        std::array<strv_t, 2> names = {"cslib.h++", "cslib.c++"};
+        cslib::common_prefix(names); // "cslib."
+    */
     if (strs.empty())
       return "";
-    strv_t prefix(strs.at(0));
-    for (size_t i = 1; i < strs.size(); ++i) {
-      const strv_t current(strs.at(i));
-      size_t j = 0;
-      for (; j < prefix.size() && j < current.size(); ++j) {
-        if (prefix.at(j) != current.at(j))
-        break;
-      }
-      prefix = prefix.substr(0, j);
+    strv_t prefix = strs.front();
+    for (strv_t current : strs.subspan(1)) {
+      prefix = prefix.substr(0, common_prefix_length(prefix.data(), current.data(), std::min(prefix.size(), current.size())));
       if (prefix.empty())
         break;
     }
-    return str_t(prefix);
+    return prefix;
   }
-
-  str_t common_suffix(std::vector<str_t> strs) noexcept { // TODO make more readable
+  inline strv_t common_suffix(std::span<const strv_t> strs) noexcept {
     if (strs.empty())
       return "";
-    std::string_view suffix(strs.at(0));
-    for (size_t i = 1; i < strs.size(); ++i) {
-      const std::string_view current(strs.at(i));
-      size_t j = 0;
-      while (j < suffix.size() && j < current.size() && suffix.at(suffix.size() - 1 - j) == current.at(current.size() - 1 - j))
-        ++j;
-      suffix = suffix.substr(suffix.size() - j, j);
+    strv_t suffix = strs.front();
+    for (strv_t current : strs.subspan(1)) {
+      const size_t same = common_suffix_length(suffix.data() + suffix.size(), current.data() + current.size(), std::min(suffix.size(), current.size()));
+      suffix = suffix.substr(suffix.size() - same);
       if (suffix.empty())
-    break;
+        break;
     }
-    return str_t(suffix);
+    return suffix;
+  }
+  str_t common_prefix(const std::vector<str_t>& strs) noexcept {
+    const std::vector<strv_t> views(strs.begin(), strs.end());
+    return str_t(common_prefix(std::span<const strv_t>(views)));
+  }
+  str_t common_suffix(const std::vector<str_t>& strs) noexcept {
+    const std::vector<strv_t> views(strs.begin(), strs.end());
+    return str_t(common_suffix(std::span<const strv_t>(views)));
   }
 
 
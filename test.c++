@@ -4,6 +4,9 @@
 #include <set>
 #include <list>
 #include <functional>
+#ifndef _WIN32
+  #include <sys/resource.h>
+#endif
 using namespace cslib;
 
 
@@ -137,10 +140,116 @@ int main() {
     log(sh_call("cd ./").has_value(), "system call to run");
     log(!sh_call(scramble_name(64)/*random name*/), "sh_call should recognize errors.");
     log(sh_call(scramble_name(64)/*random name*/).error() != 0, "sh_call should return the error-code upon faliure");
+    #ifndef _WIN32
+      log(sh_call("echo hi").value_or("") == "hi\n", "sh_call should return the output of the command");
+      log(sh_call("exit 3").error() == 3 << 8, "sh_call should return the raw wait status like pclose did");
+    #endif
   }
 
 
 
+  #ifndef _WIN32
+  title("Testing/Benchmarking cslib::Process and cslib::run_batch"); {
+    // Arguments reach the program untouched, no shell involved
+    {
+      Process echo({"printf", "%s|%s", "a b", "$HOME;'\""});
+      ProcessResult result = echo.run();
+      log(result.exitCode == 0 && result.out == "a b|$HOME;'\"", "Process should pass arguments without a shell");
+      ProcessResult again = echo.run();
+      log(again.exitCode == 0 && again.out == result.out && echo.argv.size() == 4, "Process should be reusable after run()");
+      Process first({"echo", "1"}), second({"echo", "2"});
+      std::array<Process*, 2> both = {&first, &second};
+      run_batch(both, 2);
+      log(first.result.out == "1\n" && second.result.out == "2\n", "run_batch should drive processes in place through pointers");
+    }
+
+    // Exit codes and stderr
+    {
+      ProcessResult result = Process::shell("echo out; echo err >&2; exit 7").run();
+      log(result.exitCode == 7, "Process should report the exit code");
+      log(result.out == "out\n" && result.err == "err\n", "Process should capture stdout and stderr separately");
+      log(Process({scramble_name(32)}).run().exitCode == 127, "Unknown programs should be reported with exit code 127");
+    }
+
+    // Output larger than the pipe buffer is streamed in chunks
+    {
+      Process big({"head", "-c", "4000000", "/dev/zero"});
+      size_t total = 0, chunks = 0;
+      big.onStdout = [&](strv_t chunk) { total += chunk.size(); ++chunks; };
+      ProcessResult result = big.run();
+      log(total == 4000000 && result.out.empty(), "onStdout should receive every byte instead of result.out");
+      log(chunks > 1, "Large output should arrive in several chunks");
+    }
+
+    // Timeouts kill the whole process group
+    {
+      Process sleeper = Process::shell("sleep 5; sleep 5");
+      sleeper.timeout = std::chrono::milliseconds(100);
+      bm.reset();
+      ProcessResult result = sleeper.run();
+      log(result.timedOut && result.exitCode == 128 + SIGKILL, "Timed out process should be killed");
+      log(bm.elapsed_ms() < 2000, "Timeout should not wait for the child (or its children)");
+    }
+
+    // A child that closed its pipes is waited for without polling in a loop
+    {
+      auto wakeups = [] {
+        struct rusage usage = {};
+        ::getrusage(RUSAGE_THREAD, &usage);
+        return usage.ru_nvcsw + usage.ru_nivcsw;
+      };
+      Process quiet = Process::shell("exec >&- 2>&-; sleep 0.3; exit 4");
+      long before = wakeups();
+      ProcessResult result = quiet.run();
+      long woken = wakeups() - before;
+      std::cout << "  context switches while waiting 300ms for a silent child: " << woken << '\n';
+      log(result.exitCode == 4, "Process should be reaped after closing its pipes early");
+      log(woken < 50, "Waiting for a child with closed pipes should not spin");
+
+      Process silent = Process::shell("exec >&- 2>&-; sleep 5");
+      silent.timeout = std::chrono::milliseconds(100);
+      bm.reset();
+      result = silent.run();
+      log(result.timedOut && bm.elapsed_ms() < 2000, "Timeouts still apply after the pipes are closed");
+    }
+
+    // Concurrency limit
+    {
+      const auto batch_ms = [&](size_t maxConcurrent) {
+        std::vector<Process> jobs;
+        for (size_t i = 0; i < 4; ++i)
+          jobs.emplace_back(std::vector<str_t>{"sleep", "0.2"});
+        bm.reset();
+        run_batch(jobs, maxConcurrent);
+        return bm.elapsed_ms();
+      };
+      const double limited = batch_ms(2), unlimited = batch_ms(4);
+      log(limited >= 390, "run_batch should respect maxConcurrent");
+      log(unlimited < 390, "run_batch should run processes at the same time");
+    }
+
+    // Batch vs sequential sh_call
+    {
+      constexpr size_t JOBS = 200;
+      bm.reset();
+      for (size_t i = 0; i < JOBS; ++i)
+        sh_call("echo " + std::to_string(i));
+      const double sequentialMs = bm.elapsed_ms();
+      std::vector<Process> jobs;
+      for (size_t i = 0; i < JOBS; ++i)
+        jobs.emplace_back(std::vector<str_t>{"echo", std::to_string(i)});
+      bm.reset();
+      run_batch(jobs, 16);
+      const double batchMs = bm.elapsed_ms();
+      log(std::ranges::all_of(range(int(JOBS)), [&](int i) { return jobs.at(i).result.out == std::to_string(i) + '\n'; }), "run_batch should keep results with their process");
+      std::cout << "  sh_call x" << JOBS << ": " << sequentialMs << "ms\n";
+      std::cout << "  run_batch x" << JOBS << " (16 at a time): " << batchMs << "ms\n";
+    }
+  }
+  #endif
+
+
+
   title("Testing cslib::contains"); {
     std::vector<int> vec = {1, 2, 3, 4, 5};
     std::deque<int> deq = {1, 2, 3, 4, 5};
@@ -378,6 +487,87 @@ int main() {
 
 
 
+  title("Testing cslib::SplitView and cslib::find_sequence"); {
+    auto collect = [](strv_t text, strv_t delimiter) {
+      std::vector<strv_t> tokens;
+      for (strv_t token : SplitView(text, delimiter))
+        tokens.push_back(token);
+      return tokens;
+    };
+    log(collect("a,b,c", ",") == std::vector<strv_t>{"a", "b", "c"}, "SplitView splits by single char");
+    log(collect("one--two--three", "--") == std::vector<strv_t>{"one", "two", "three"}, "SplitView splits by multi-char delimiter");
+    log(collect(",a,,b,", ",") == std::vector<strv_t>{"", "a", "", "b", ""}, "SplitView keeps empty tokens");
+    log(collect("", ",").empty(), "SplitView of empty text yields nothing");
+    log(collect("abc", "") == std::vector<strv_t>{"a", "b", "c"}, "SplitView with empty delimiter yields characters");
+    log(collect("abc", "abcd") == std::vector<strv_t>{"abc"}, "SplitView with delimiter longer than text");
+    log(std::ranges::distance(SplitView("x;y;z", ";")) == 3, "SplitView works with std::ranges");
+
+    str_t text = "alpha";
+    SplitView view(text, "l");
+    log((*view.begin()).data() == text.data(), "SplitView tokens point into the original text");
+
+    // Compare the SIMD search with std::string_view::find around every block boundary
+    bool good = true;
+    for (size_t length : {1, 2, 3, 5, 16, 17})
+      for (size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 200}) {
+        str_t needle(length, 'n');
+        needle.front() = 'N';
+        for (size_t at = 0; at + length <= size; ++at) {
+          str_t hay(size, 'N'); // Lots of partial matches
+          hay.replace(at, length, needle);
+          const char* found = find_sequence(hay.data(), hay.data() + hay.size(), needle);
+          good = good && size_t(found - hay.data()) == strv_t(hay).find(needle);
+        }
+        str_t missing(size, 'n');
+        good = good && find_sequence(missing.data(), missing.data() + size, needle) == missing.data() + size;
+      }
+    log(good, "find_sequence matches string_view::find for every length and offset");
+
+    // Benchmark: separate vs SplitView over a large delimited file
+    str_t csv;
+    for (int i : range(200'000))
+      csv += to_str(i, ";name", i % 97, ";", i * 3, "\n");
+    bm.reset();
+    size_t separated = separate(csv, ";").size();
+    double separateMs = bm.elapsed_ms();
+    bm.reset();
+    size_t viewed = 0;
+    for (strv_t token : SplitView(csv, ";"))
+      viewed += !token.empty();
+    double viewMs = bm.elapsed_ms();
+    std::cout << "  separate: " << separateMs << "ms, SplitView: " << viewMs << "ms (" << csv.size() / 1024 << "KiB)\n";
+    log(separated == viewed, "SplitView yields as many tokens as separate");
+    log(viewMs < separateMs, "SplitView is faster than separate");
+  }
+
+
+
+  title("Testing cslib::common_prefix and cslib::common_suffix"); {
+    log(common_prefix(std::vector<str_t>{"cslib.h++", "cslib.c++", "cslib.md"}) == "cslib.", "common_prefix of three strings");
+    log(common_suffix(std::vector<str_t>{"test.c++", "cslib.c++", "main.c++"}) == ".c++", "common_suffix of three strings");
+    log(common_prefix(std::vector<str_t>{}).empty() && common_suffix(std::vector<str_t>{}).empty(), "empty input gives empty result");
+    log(common_prefix(std::vector<str_t>{"only"}) == "only" && common_suffix(std::vector<str_t>{"only"}) == "only", "single string is its own prefix/suffix");
+    log(common_prefix(std::vector<str_t>{"abc", "xyz"}).empty() && common_suffix(std::vector<str_t>{"abc", "xyz"}).empty(), "nothing in common");
+    log(common_prefix(std::vector<str_t>{"abc", ""}).empty(), "empty string ends the prefix");
+
+    // Long inputs so the vector paths (and their tails) are used
+    bool good = true;
+    for (size_t size : {15, 16, 17, 31, 32, 33, 100})
+      for (size_t differ = 0; differ < size; ++differ) {
+        str_t a(size, 'q'), b(size, 'q');
+        b.at(differ) = 'Q';
+        std::array<strv_t, 2> pair = {a, b};
+        good = good && common_prefix(pair).size() == differ;
+        good = good && common_suffix(pair).size() == size - differ - 1;
+      }
+    log(good, "common_prefix/common_suffix find the first difference at any offset");
+    std::array<strv_t, 2> views = {"prefix_one_suffix", "prefix_two_suffix"};
+    log(common_prefix(views) == "prefix_" && common_suffix(views) == "_suffix", "span overloads work without copying");
+    log(common_prefix(views).data() == views.at(0).data(), "span overload returns a view into the input");
+  }
+
+
+
   title("Testing cslib::roll_dice"); {
     bool good = true;
     for ([[maybe_unused]] int _ : range(1'000))
@@ -593,6 +783,16 @@ int main() {
       log(out.str().empty(), "do_io writes empty string to output stream");
     }
 
+    // Input stream in a failed state
+    {
+      std::ifstream missing("/nonexistent/" + scramble_name());
+      std::ostringstream out;
+      log(!caught([&] { return do_io(missing, out); }).has_value(), "do_io throws when the input file failed to open");
+      std::istringstream broken("data");
+      broken.setstate(std::ios::badbit);
+      log(!caught([&] { return do_io(broken, out); }).has_value() && out.str().empty(), "do_io throws for a bad input stream and writes nothing");
+    }
+
     // Non-seekable input stream
     {
       struct NonSeekableBuf : public std::stringbuf {
@@ -700,11 +900,226 @@ int main() {
       log(res1.has_value() && res2.has_value(), "do_io succeeds on sequential calls");
       log(out1.str() == "abc123" && out2.str() == "abc123", "do_io produces identical output for sequential calls");
     }
+
+    // Chunked streaming with progress callback
+    {
+      str_t data = scramble_name(10'000);
+      std::istringstream in(data);
+      std::ostringstream out;
+      std::vector<size_t> progress;
+      maybe<void> res = caught([&] { do_io(in, out, 1'000, [&](size_t bytes) { progress.push_back(bytes); }); });
+      log(res.has_value() && out.str() == data, "do_io with small chunks copies everything in order");
+      log(progress.size() == 10 && progress.back() == data.size(), "do_io reports progress once per chunk");
+      log(!caught([&] { do_io(in, out, 0); }).has_value(), "do_io rejects a chunk size of 0");
+    }
+
+    // Chunk size not dividing the input
+    {
+      str_t data = scramble_name(1'234);
+      std::istringstream in(data);
+      std::ostringstream out;
+      do_io(in, out, 100);
+      log(out.str() == data, "do_io handles a trailing partial chunk");
+    }
+
+#ifndef _WIN32
+    // File descriptor fast paths
+    {
+      TempFolder dir;
+      str_t data = scramble_name(300'000);
+      File source(dir / "source.txt", true);
+      source.edit_text(data);
+
+      // file -> file (copy_file_range)
+      int inFd = ::open(source.str().c_str(), O_RDONLY);
+      int outFd = ::open((dir / "copy.txt").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      size_t calls = 0;
+      size_t copied = do_io(inFd, outFd, IO_CHUNK_SIZE, [&](size_t) { ++calls; });
+      ::close(inFd);
+      ::close(outFd);
+      log(copied == data.size() && File(dir / "copy.txt").read_text() == data, "do_io(fd, fd) copies file to file");
+      log(calls >= 2, "do_io(fd, fd) reports progress per chunk");
+
+      // pipe -> file (splice) and file -> pipe (sendfile)
+      int fds[2];
+      ::pipe(fds);
+      std::future<size_t> writer = do_in_parallel([&] {
+        int fd = ::open(source.str().c_str(), O_RDONLY);
+        size_t n = do_io(fd, fds[1]);
+        ::close(fd);
+        ::close(fds[1]);
+        return n;
+      });
+      outFd = ::open((dir / "piped.txt").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      copied = do_io(fds[0], outFd);
+      ::close(fds[0]);
+      ::close(outFd);
+      log(writer.get() == data.size() && copied == data.size(), "do_io(fd, fd) moves data through pipes");
+      log(File(dir / "piped.txt").read_text() == data, "do_io(fd, fd) keeps pipe content intact");
+
+      // Non-blocking descriptors: wait in poll() instead of spinning on EAGAIN
+      auto thread_cpu_ms = [] {
+        struct rusage usage = {};
+        ::getrusage(RUSAGE_THREAD, &usage);
+        return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+      };
+      ::pipe(fds);
+      ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+      writer = do_in_parallel([&] {
+        pause(200);
+        size_t n = size_t(std::max<ssize_t>(::write(fds[1], data.data(), 1000), 0));
+        ::close(fds[1]);
+        return n;
+      });
+      outFd = ::open((dir / "late.txt").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      double cpuBefore = thread_cpu_ms();
+      copied = do_io(fds[0], outFd);
+      double cpuMs = thread_cpu_ms() - cpuBefore;
+      ::close(fds[0]);
+      ::close(outFd);
+      log(writer.get() == 1000 && copied == 1000, "do_io(fd, fd) waits for a non-blocking pipe to get data");
+      log(cpuMs < 100, "do_io(fd, fd) doesn't spin while a non-blocking input is empty");
+
+      int sockets[2];
+      ::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+      ::fcntl(sockets[0], F_SETFL, ::fcntl(sockets[0], F_GETFL) | O_NONBLOCK);
+      std::future<str_t> reader = do_in_parallel([&] {
+        pause(200);
+        str_t received;
+        char chunk[4096];
+        for (ssize_t got; (got = ::read(sockets[1], chunk, sizeof(chunk))) > 0;)
+          received.append(chunk, size_t(got));
+        return received;
+      });
+      inFd = ::open(source.str().c_str(), O_RDONLY);
+      cpuBefore = thread_cpu_ms();
+      copied = do_io(inFd, sockets[0]);
+      cpuMs = thread_cpu_ms() - cpuBefore;
+      ::close(inFd);
+      ::shutdown(sockets[0], SHUT_WR);
+      log(copied == data.size() && reader.get() == data, "do_io(fd, fd) waits for a full non-blocking socket to drain");
+      log(cpuMs < 100, "do_io(fd, fd) doesn't spin while a non-blocking output is full");
+      ::close(sockets[0]);
+      ::close(sockets[1]);
+
+      // read()/write() fallback (socket to socket) with a non-blocking output
+      int input[2], output[2];
+      ::socketpair(AF_UNIX, SOCK_STREAM, 0, input);
+      ::socketpair(AF_UNIX, SOCK_STREAM, 0, output);
+      ::fcntl(output[0], F_SETFL, ::fcntl(output[0], F_GETFL) | O_NONBLOCK);
+      std::future<void> feeder = do_in_parallel([&] {
+        for (size_t sent = 0; sent < data.size();)
+          sent += size_t(std::max<ssize_t>(::write(input[1], data.data() + sent, data.size() - sent), 0));
+        ::shutdown(input[1], SHUT_WR);
+      });
+      reader = do_in_parallel([&] {
+        pause(200);
+        str_t received;
+        char chunk[4096];
+        for (ssize_t got; (got = ::read(output[1], chunk, sizeof(chunk))) > 0;)
+          received.append(chunk, size_t(got));
+        return received;
+      });
+      copied = do_io(input[0], output[0]);
+      ::shutdown(output[0], SHUT_WR);
+      feeder.get();
+      log(copied == data.size() && reader.get() == data, "do_io(fd, fd) read/write fallback waits on a full non-blocking output");
+      for (int fd : {input[0], input[1], output[0], output[1]})
+        ::close(fd);
+
+      // copy_self_into keeps the permissions and honors copy_options
+      Folder target(dir / "target", true);
+      stdfs::permissions(source, stdfs::perms::owner_read | stdfs::perms::owner_write | stdfs::perms::owner_exec);
+      File copy = source.copy_self_into(target);
+      log(copy.read_text() == data, "copy_self_into copies through do_io");
+      log(stdfs::status(copy).permissions() == stdfs::status(source).permissions(), "copy_self_into copies permissions");
+      log(!caught([&] { return source.copy_self_into(target); }).has_value(), "copy_self_into throws if the file exists and no option allows it");
+      source.edit_text("changed");
+      File skipped = source.copy_self_into(target, stdfs::copy_options::skip_existing);
+      log(skipped.read_text() == data, "copy_self_into with skip_existing leaves the existing file");
+    }
+
+    // Throughput and peak RSS: streaming vs everything in memory
+    {
+      /*
+        ru_maxrss never goes down, so each variant
+        resets the high-water mark (clear_refs 5) and
+        reads VmHWM afterwards. Without that (not Linux,
+        no permission) the numbers are only printed.
+      */
+      auto reset_peak_rss = [] {
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+        clearRefs.flush();
+        return bool(clearRefs);
+      };
+      auto peak_rss_kb = [] {
+        std::ifstream status("/proc/self/status");
+        for (str_t line; std::getline(status, line);)
+          if (line.starts_with("VmHWM:"))
+            return std::stol(line.substr(6));
+        struct rusage usage = {};
+        ::getrusage(RUSAGE_SELF, &usage);
+        return long(usage.ru_maxrss);
+      };
+      auto current_rss_kb = [] {
+        std::ifstream status("/proc/self/status");
+        for (str_t line; std::getline(status, line);)
+          if (line.starts_with("VmRSS:"))
+            return std::stol(line.substr(6));
+        return 0L;
+      };
+      constexpr size_t MB = 1024 * 1024;
+      constexpr size_t SIZE = 64 * MB;
+      TempFolder dir;
+      {
+        std::ofstream big(dir / "big.bin", std::ios::binary);
+        str_t block(MB, 'R');
+        for ([[maybe_unused]] int _ : range(SIZE / MB))
+          big.write(block.data(), block.size());
+      }
+      bool resettable = true;
+      auto measure = [&](auto&& copy, double& ms) {
+        resettable = reset_peak_rss() && resettable;
+        long before = current_rss_kb();
+        bm.reset();
+        copy();
+        ms = bm.elapsed_ms();
+        return peak_rss_kb() - before;
+      };
+
+      double streamMs = 0, kernelMs = 0, bufferedMs = 0;
+      long rssStreamed = measure([&] {
+        std::ifstream in(dir / "big.bin", std::ios::binary);
+        std::ofstream out(dir / "streamed.bin", std::ios::binary);
+        do_io(in, out);
+      }, streamMs);
+      long rssKernel = measure([&] { File(dir / "big.bin").copy_self_into(Folder(dir / "kernel", true)); }, kernelMs);
+      long rssBuffered = measure([&] {
+        std::ifstream in(dir / "big.bin", std::ios::binary);
+        std::vector<char> data = read_data(in);
+        std::ofstream(dir / "buffered.bin", std::ios::binary).write(data.data(), data.size());
+      }, bufferedMs);
+
+      auto mb_per_s = [&](double ms) { return (SIZE / double(MB)) / (ms / 1000.0); };
+      std::cout << "  streamed do_io: " << mb_per_s(streamMs) << "MB/s, peak RSS +" << rssStreamed / 1024 << "MB\n"
+                << "  kernel copy:    " << mb_per_s(kernelMs) << "MB/s, peak RSS +" << rssKernel / 1024 << "MB\n"
+                << "  read_data copy: " << mb_per_s(bufferedMs) << "MB/s, peak RSS +" << rssBuffered / 1024 << "MB\n";
+      log(stdfs::file_size(dir / "streamed.bin") == SIZE && stdfs::file_size(dir / "kernel" / "big.bin") == SIZE, "Streaming copies are complete");
+      if (resettable) {
+        log(rssBuffered >= long(SIZE / 2 / 1024), "Peak RSS sees the in-memory copy (measurement works)"); // Half: malloc may reuse pages that are already resident
+        log(rssStreamed < 16 * 1024, "Streaming do_io keeps peak RSS bounded");
+        log(rssKernel < 16 * 1024, "Kernel-side copy keeps peak RSS bounded");
+      }
+      else
+        std::cout << "  (peak RSS can't be reset here, not asserting on it)\n";
+    }
+#endif
   }
 
 
 
-  title("Testing cslib::TimeStamp"); {
+  title("Testing/Benchmarking cslib::TimeStamp"); {
     // Default constructor: should produce a time near now
     {
       auto before = std::chrono::system_clock::now();
@@ -795,6 +1210,243 @@ int main() {
       log(ts.hour() == 23 && ts.minute() == 59 && ts.second() == 59, "TimeStamp end of day correct");
       log(ts.day() == 31 && ts.month() == 12 && ts.year() == 2025, "TimeStamp end of year correct");
     }
+
+    // The previous as_str(), as reference and baseline
+    const auto old_as_str = [](const TimeStamp& ts) {
+      std::time_t time = std::chrono::system_clock::to_time_t(ts.timePoint);
+      return (std::ostringstream() << std::put_time(std::gmtime(&time), "%H:%M:%S %d-%m-%Y")).str();
+    };
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int64_t> anySecond(-2'000'000'000, 7'000'000'000); // ~1906 to ~2191
+    std::vector<TimeStamp::time_point_t> points;
+    for (size_t i = 0; i < 10000; ++i)
+      points.emplace_back(std::chrono::seconds(anySecond(rng)) + std::chrono::nanoseconds(rng() % 1'000'000'000));
+
+    // Cached fields and the fast formatter agree with the standard library
+    {
+      bool sameText = true, sameFields = true;
+      for (const TimeStamp::time_point_t& tp : points) {
+        const TimeStamp ts(tp);
+        sameText = sameText && ts.as_str() == old_as_str(TimeStamp(std::chrono::floor<std::chrono::seconds>(tp))); // to_time_t rounds towards 1970
+        const std::chrono::year_month_day ymd(std::chrono::floor<std::chrono::days>(tp));
+        sameFields = sameFields && ts.year() == size_t(int(ymd.year())) && ts.month() == unsigned(ymd.month()) && ts.day() == unsigned(ymd.day());
+      }
+      log(sameText, "as_str() should match the std::put_time output");
+      log(sameFields, "Cached civil fields should match std::chrono");
+    }
+
+    // Changing the time point keeps the fields right
+    {
+      TimeStamp ts(1, 2, 3, 4, 5, 2025);
+      ts.timePoint += std::chrono::hours(24);
+      log(ts.day() == 5 && ts.as_str() == "01:02:03 05-05-2025", "Assigning timePoint directly should not use stale fields");
+      ts.set(TimeStamp(23, 59, 59, 31, 12, 1999).timePoint);
+      log(ts.year() == 1999 && ts.cacheOf == ts.timePoint, "set() should refresh the cached fields");
+    }
+
+    // ISO 8601 with sub-seconds
+    {
+      TimeStamp ts(TimeStamp(14, 30, 15, 10, 8, 2025).timePoint + std::chrono::microseconds(42'123));
+      std::array<char, TimeStamp::MAX_LENGTH> buffer;
+      log(strv_t(buffer.data(), ts.format_to(buffer.data(), TimeStamp::Format::Iso8601)) == "2025-08-10T14:30:15.042Z", "ISO 8601 with milliseconds");
+      log(strv_t(buffer.data(), ts.format_to(buffer.data(), TimeStamp::Format::Iso8601, 6)) == "2025-08-10T14:30:15.042123Z", "ISO 8601 with microseconds");
+      log(strv_t(buffer.data(), ts.format_to(buffer.data(), TimeStamp::Format::Iso8601, 0)) == "2025-08-10T14:30:15Z", "ISO 8601 without fraction");
+      TimeStamp before1970(TimeStamp(0, 0, 0, 1, 1, 1970).timePoint - std::chrono::milliseconds(1));
+      log(strv_t(buffer.data(), before1970.format_to(buffer.data(), TimeStamp::Format::Iso8601)) == "1969-12-31T23:59:59.999Z", "Times before 1970 round down");
+    }
+
+    // Parsing
+    {
+      log(TimeStamp::parse("14:30:15 10-08-2025").transform([](const TimeStamp& ts) { return ts.timePoint; }) == TimeStamp(14, 30, 15, 10, 8, 2025).timePoint, "parse() reads the classic layout");
+      std::optional<TimeStamp> iso = TimeStamp::parse("2025-08-10T14:30:15.5Z", TimeStamp::Format::Iso8601);
+      log(iso && iso->second() == 15 && iso->civil().nanosecond == 500'000'000, "parse() reads ISO 8601 with a short fraction");
+      log(TimeStamp::parse("2025-08-10 14:30:15", TimeStamp::Format::Iso8601).has_value(), "parse() accepts a space instead of 'T'");
+      log(!TimeStamp::parse("14:30:15 29-02-2023"), "parse() rejects dates that don't exist");
+      log(!TimeStamp::parse("24:00:00 01-01-2025"), "parse() rejects hour 24");
+      log(!TimeStamp::parse("14:30:15 10-08-2025 "), "parse() rejects trailing text");
+      log(!TimeStamp::parse("2025-08-10T14:30:15.Z", TimeStamp::Format::Iso8601), "parse() rejects an empty fraction");
+      log(!TimeStamp::parse("2025-08-10T14:3a:15Z", TimeStamp::Format::Iso8601), "parse() rejects non-digits");
+    }
+
+    // Batches round trip
+    {
+      for (TimeStamp::Format format : {TimeStamp::Format::Classic, TimeStamp::Format::Iso8601}) {
+        std::vector<TimeStamp::time_point_t> sorted = points;
+        std::ranges::sort(sorted);
+        const str_t column = TimeStamp::format_all(sorted, format, 9);
+        std::vector<strv_t> lines;
+        for (strv_t line : SplitView(column, "\n"))
+          if (!line.empty())
+            lines.push_back(line);
+        std::vector<TimeStamp::time_point_t> parsed(lines.size());
+        const bool allParsed = TimeStamp::parse_all(lines, parsed, format) == lines.size();
+        bool same = lines.size() == sorted.size();
+        for (size_t i = 0; same && i < sorted.size(); ++i)
+          same = format == TimeStamp::Format::Iso8601 ? parsed.at(i) == sorted.at(i) : parsed.at(i) == std::chrono::floor<std::chrono::seconds>(sorted.at(i));
+        log(allParsed && same, "format_all() and parse_all() should round trip");
+      }
+      std::vector<strv_t> texts = {"00:00:00 01-01-2000", "oops", "00:00:00 02-01-2000"};
+      std::vector<TimeStamp::time_point_t> out(texts.size());
+      log(TimeStamp::parse_all(texts, out) == 1, "parse_all() stops at the first invalid text");
+    }
+
+    // Old as_str() vs cached fields and format_to
+    {
+      constexpr size_t N = 1'000'000;
+      std::vector<TimeStamp::time_point_t> column(N);
+      const auto start = std::chrono::system_clock::now();
+      for (size_t i = 0; i < N; ++i)
+        column.at(i) = start + std::chrono::milliseconds(i * 7);
+      const TimeStamp sample(start);
+      size_t sink = 0;
+
+      bm.reset();
+      for (size_t i = 0; i < N / 10; ++i)
+        sink += old_as_str(TimeStamp(column.at(i))).size();
+      const double oldNs = bm.elapsed_ns() / double(N / 10);
+      bm.reset();
+      for (size_t i = 0; i < N; ++i)
+        sink += TimeStamp(column.at(i)).as_str().size();
+      const double newNs = bm.elapsed_ns() / double(N);
+      std::array<char, TimeStamp::MAX_LENGTH> buffer;
+      bm.reset();
+      for (size_t i = 0; i < N; ++i)
+        sink += size_t(sample.format_to(buffer.data()) - buffer.data()) + buffer.at(i % 8);
+      const double cachedNs = bm.elapsed_ns() / double(N);
+      bm.reset();
+      const str_t formatted = TimeStamp::format_all(column);
+      const double batchNs = bm.elapsed_ns() / double(N);
+      std::vector<strv_t> lines;
+      for (strv_t line : SplitView(formatted, "\n"))
+        if (!line.empty())
+          lines.push_back(line);
+      bm.reset();
+      TimeStamp::parse_all(lines, column);
+      const double parseNs = bm.elapsed_ns() / double(N);
+      do_not_optimize(sink);
+
+      std::cout << "  old as_str(): " << oldNs << "ns per time stamp\n";
+      std::cout << "  as_str(): " << newNs << "ns per time stamp\n";
+      std::cout << "  format_to() with cached fields: " << cachedNs << "ns per time stamp\n";
+      std::cout << "  format_all(): " << batchNs << "ns per time stamp (" << formatted.size() / (batchNs * double(N) / 1e9) / 1e6 << "MB/s)\n";
+      std::cout << "  parse_all(): " << parseNs << "ns per time stamp\n";
+      log(newNs < oldNs, "as_str() should be faster than before");
+    }
+  }
+
+
+
+  title("Testing/Benchmarking cslib::Out and cslib::AsyncOut"); {
+
+    // Blocks the writer until opened
+    struct GateBuf : public std::stringbuf {
+      std::atomic<bool> open = false;
+      std::streamsize xsputn(const char_type* s, std::streamsize n) override {
+        while (!open)
+          pause(1);
+        return std::stringbuf::xsputn(s, n);
+      }
+    };
+
+    // Synchronous Out stays the default
+    {
+      std::ostringstream stream;
+      Out out(stream, "SYNC:", "");
+      out << "hello";
+      log(stream.str().starts_with('[') && stream.str().ends_with("]SYNC: hello"), "Out writes timestamp, prefix and message immediately");
+    }
+
+    // Basic async record
+    {
+      std::ostringstream stream;
+      sptr<AsyncLog> backend = std::make_shared<AsyncLog>(64);
+      AsyncOut out(stream, "ASYNC:", "", backend);
+      out << "value=" << 42 << ' ' << 1.5 << std::endl;
+      out.flush();
+      log(stream.str().starts_with('[') && stream.str().ends_with("]ASYNC: value=42 1.5\n"), "AsyncOut writes one record per expression after flush()");
+      log(backend->dropped() == 0, "Nothing dropped with free capacity");
+    }
+
+    // Many producers, every record arrives whole
+    {
+      std::ostringstream stream;
+      sptr<AsyncLog> backend = std::make_shared<AsyncLog>(256);
+      AsyncOut out(stream, "", "", backend);
+      parallel_for(range(4'000), [&out](int i) { out << "record " << i << '\n'; });
+      out.flush();
+      std::vector<str_t> lines = separate(stream.str(), "\n");
+      lines.pop_back(); // Trailing newline
+      bool wellFormed = lines.size() == 4'000;
+      for (const str_t& line : lines)
+        wellFormed = wellFormed && line.starts_with('[') && line.find("]record ") != str_t::npos;
+      log(wellFormed, "AsyncOut keeps records from concurrent producers intact");
+    }
+
+    // Drop and Count policies
+    {
+      GateBuf buf;
+      std::ostream stream(&buf);
+      sptr<AsyncLog> backend = std::make_shared<AsyncLog>(2, AsyncLog::OnFull::Count);
+      AsyncOut out(stream, "", "", backend);
+      for (int i : range(10))
+        out << "r" << i << '\n';
+      log(backend->dropped() >= 8, "Full buffer drops records with Count policy");
+      buf.open = true;
+      out.flush(); // Let the consumer free the slots
+      out << "after\n";
+      out.flush();
+      log(buf.str().find("log records dropped]") != str_t::npos, "Count policy reports how many records got lost");
+      log(buf.str().find("after") != str_t::npos, "Logging recovers once there is room again");
+    }
+
+    // Block policy waits instead of losing records
+    {
+      GateBuf buf;
+      std::ostream stream(&buf);
+      sptr<AsyncLog> backend = std::make_shared<AsyncLog>(2, AsyncLog::OnFull::Block);
+      AsyncOut out(stream, "", "", backend);
+      std::future<void> producer = do_in_parallel([&out] {
+        for (int i : range(10))
+          out << "r" << i << '\n';
+      });
+      pause(20);
+      log(producer.wait_for(std::chrono::seconds(0)) != std::future_status::ready, "Block policy stalls the producer while full");
+      buf.open = true;
+      producer.get();
+      out.flush();
+      log(backend->dropped() == 0 && separate(buf.str(), "\n").size() == 11, "Block policy writes every record");
+    }
+
+    // Shutdown drains and later records are dropped
+    {
+      std::ostringstream stream;
+      sptr<AsyncLog> backend = std::make_shared<AsyncLog>(64);
+      AsyncOut out(stream, "", "", backend);
+      out << "before\n";
+      backend->shutdown();
+      out << "after\n";
+      out.flush();
+      log(stream.str().find("before") != str_t::npos && stream.str().find("after") == str_t::npos, "shutdown() drains pending records and drops later ones");
+    }
+
+    // Benchmark: caller-side cost of Out vs AsyncOut
+    {
+      TempFile syncFile, asyncFile;
+      std::ofstream syncStream(syncFile.isAt), asyncStream(asyncFile.isAt);
+      Out syncOut(syncStream, "BENCH:", Green);
+      AsyncOut asyncOut(asyncStream, "BENCH:", Green, std::make_shared<AsyncLog>(1 << 16));
+      bm.reset();
+      for (int i : range(20'000))
+        syncOut << "iteration " << i << '\n';
+      double syncMs = bm.elapsed_ms();
+      bm.reset();
+      for (int i : range(20'000))
+        asyncOut << "iteration " << i << '\n';
+      double asyncMs = bm.elapsed_ms();
+      asyncOut.flush();
+      std::cout << "  Out: " << syncMs << "ms, AsyncOut: " << asyncMs << "ms (20'000 records)\n";
+      log(asyncMs < syncMs, "AsyncOut is cheaper for the caller than Out");
+    }
   }
 
 
@@ -963,6 +1615,78 @@ int main() {
       log(content == "initial content", "read_text returns correct file content");
     }
 
+    // map() gives a zero-copy view of regular files
+    {
+      File f(tempFile);
+      MappedFile mapped = f.map();
+      log(mapped.view() == "initial content", "map() view matches file content");
+      log(mapped.bytes().size() == mapped.size() && mapped.size() == 15, "map() bytes span has the file's size");
+      log(IS_WINDOWS || mapped.is_mapped(), "map() uses mmap for regular files");
+      mapped.advise(MappedFile::Access::Random);
+      MappedFile moved = std::move(mapped);
+      log(moved.view() == "initial content" && mapped.view().empty(), "MappedFile moves its view along");
+    }
+
+    // map() on an empty file
+    {
+      File f(tempDir / "empty.txt", true);
+      MappedFile mapped = f.map();
+      log(mapped.size() == 0 && mapped.view().empty(), "map() on an empty file gives an empty view");
+      log(f.read_text().empty(), "read_text on an empty file returns empty string");
+    }
+
+    // read_text() copies through read(), not a mapping
+    {
+      File f(tempDir / "large.txt", true);
+      str_t payload(300'000, 'L');
+      f.edit_text(payload);
+      log(f.read_text() == payload, "read_text reads files larger than one read buffer");
+      log(MappedFile::read_copy(f.isAt) == payload, "MappedFile::read_copy reads the whole file");
+      log(MappedFile::read_copy(f.isAt).capacity() < payload.size() * 5 / 4, "read_copy doesn't grow a buffer that fits exactly");
+      log(!caught([&]{ return MappedFile::read_copy(tempDir / "missing.txt"); }).has_value(), "read_copy of a missing file throws");
+    }
+
+    // MappedFile falls back to a bulk read for pipes
+    if constexpr (!IS_WINDOWS) {
+      stdfs::path fifo = tempDir / "pipe";
+      sh_call("mkfifo " + fifo.string());
+      str_t payload(200'000, 'P');
+      std::future<void> writer = do_in_parallel([&]{ std::ofstream(fifo) << payload; });
+      maybe<MappedFile> mapped = caught([&]{ return MappedFile(BizarreRoad(fifo)); });
+      writer.get();
+      log(mapped.has_value() && !mapped->is_mapped(), "MappedFile reads FIFOs through the fallback");
+      log(mapped.has_value() && mapped->view() == payload, "MappedFile fallback reads the whole pipe");
+      stdfs::remove(fifo);
+    }
+
+    // map() of a missing file throws
+    {
+      maybe<MappedFile> mapped = caught([&]{ return MappedFile(tempDir / "missing.txt"); });
+      log(!mapped.has_value(), "MappedFile throws for missing files");
+    }
+
+    // Benchmark: read_text (presized read) and map() vs the old ifstream/read_data path
+    {
+      File big(tempDir / "big.txt", true);
+      big.edit_text(str_t(20'000'000, 'B'));
+      bm.reset();
+      std::ifstream in(big.isAt);
+      std::vector<char> data = read_data(in);
+      str_t viaStream(data.begin(), data.end());
+      double streamMs = bm.elapsed_ms();
+      bm.reset();
+      str_t viaRead = big.read_text();
+      double readMs = bm.elapsed_ms();
+      bm.reset();
+      MappedFile mapped = big.map();
+      size_t mappedSum = std::ranges::count(mapped.view(), 'B');
+      double mapMs = bm.elapsed_ms();
+      std::cout << "  read_data: " << streamMs << "ms, read_text: " << readMs << "ms, map() + scan: " << mapMs << "ms (20MB)\n";
+      log(viaRead == viaStream && mappedSum == viaStream.size(), "read_text and map() match read_data");
+      log(readMs < streamMs, "read_text is faster than read_data");
+      stdfs::remove(big.isAt);
+    }
+
     // edit_text() overwrites file content correctly
     {
       File f(tempFile);
@@ -1159,6 +1883,109 @@ int main() {
       log(stdfs::exists(target / "file.txt"), "copy_content_into copies files into target folder");
     }
 
+    // glob_match
+    {
+      static_assert(glob_match("*.h++", "cslib.h++"), "glob_match with leading star");
+      static_assert(glob_match("c?lib.*", "cslib.h++"), "glob_match with ? and trailing star");
+      static_assert(!glob_match("*.c++", "cslib.h++"), "glob_match rejects other extensions");
+      static_assert(glob_match("*", ""), "glob_match star matches empty");
+      static_assert(glob_match("a*b*c", "aXXbYYbc"), "glob_match backtracks over several stars");
+      static_assert(!glob_match("a*b", "aXXc"), "glob_match fails without match");
+      log(true, "glob_match evaluated at compile time");
+    }
+
+    // walk() recursive, filtered and depth limited
+    {
+      TempFolder tree;
+      for (int i : range(3)) {
+        Folder level1(tree / ("dir" + i2s(i)), true);
+        Folder level2(level1 / "nested", true);
+        for (int j : range(5)) {
+          std::ofstream(level1 / ("file" + i2s(j) + ".txt")) << j;
+          std::ofstream(level2 / ("deep" + i2s(j) + ".log")) << j;
+        }
+      }
+      std::vector<str_t> all;
+      size_t deepest = 0;
+      tree.walk([&](const stdfs::directory_entry& entry, size_t depth) {
+        all.push_back(entry.path().string());
+        deepest = std::max(deepest, depth);
+      });
+      log(all.size() == 3 + 3 + 15 + 15 && deepest == 2, "walk() visits every entry of the tree");
+
+      size_t txt = 0;
+      tree.walk([&](const stdfs::directory_entry& entry, size_t) { txt += entry.path().extension() == ".txt"; }, {.extensions = {".txt"}});
+      log(txt == 15, "walk() filters by extension");
+
+      std::vector<str_t> globbed;
+      tree.walk([&](const stdfs::directory_entry& entry, size_t) { globbed.push_back(entry.path().filename().string()); }, {.glob = "deep?.log", .directories = false});
+      log(globbed.size() == 15 && std::ranges::all_of(globbed, [](const str_t& n) { return n.starts_with("deep"); }), "walk() filters by glob");
+
+      size_t shallow = 0;
+      tree.walk([&](const stdfs::directory_entry&, size_t) { ++shallow; }, {.maxDepth = 0});
+      log(shallow == 3, "walk() honors maxDepth");
+
+      size_t dirs = 0;
+      tree.walk([&](const stdfs::directory_entry& entry, size_t) { dirs += entry.is_directory(); }, {.files = false});
+      log(dirs == 6, "walk() can report only directories");
+
+      maybe<void> thrown = caught([&] { tree.walk([](const stdfs::directory_entry&, size_t) { throw std::runtime_error("stop"); }); });
+      log(!thrown.has_value(), "walk() rethrows exceptions from the callback");
+
+      // FolderIndex
+      FolderIndex index(tree);
+      log(index.size() == 36, "FolderIndex indexes the whole tree");
+      std::optional<Road> hit = index.find("dir1/nested/deep3.log");
+      log(hit.has_value() && hit->isAt == tree.isAt / "dir1/nested/deep3.log", "FolderIndex::find returns the entry");
+      log(index.type_of("dir2") == stdfs::file_type::directory && index.type_of("dir2/file0.txt") == stdfs::file_type::regular, "FolderIndex remembers entry types");
+      log(!index.find("dir1/missing.txt").has_value() && index.find("dir1/./nested/").has_value(), "FolderIndex normalizes lookups");
+
+      std::ofstream(tree / "dir0" / "new.txt") << "new";
+      Folder added(tree / "added", true);
+      std::ofstream(added / "inside.txt") << "x";
+      stdfs::remove_all(tree / "dir2");
+      stdfs::rename(tree / "dir1" / "file0.txt", tree / "dir1" / "renamed.txt");
+      index.refresh();
+      log(index.find("dir0/new.txt").has_value(), "refresh() picks up new files");
+      log(index.find("added").has_value(), "refresh() picks up new folders");
+      log(!index.find("dir2").has_value() && !index.find("dir2/nested/deep0.log").has_value(), "refresh() drops removed trees");
+      log(!index.find("dir1/file0.txt").has_value() && index.find("dir1/renamed.txt").has_value(), "refresh() follows renames");
+      std::ofstream(added / "later.txt") << "y";
+      index.refresh();
+      log(index.find("added/later.txt").has_value(), "refresh() watches folders created after the index");
+      log(IS_WINDOWS || index.is_watching(), "FolderIndex uses inotify on Linux");
+
+      // A directory that couldn't be watched (as with ENOSPC) makes refresh() rebuild
+      #ifdef __linux__
+        for (const auto& [wd, relative] : index.watches)
+          if (relative == "dir0")
+            ::inotify_rm_watch(index.inotifyFd, wd);
+        index.watchedFully = false;
+        std::ofstream(tree / "dir0" / "unwatched.txt") << "z";
+        log(!index.is_watching(), "is_watching() is false while a directory isn't watched");
+        index.refresh();
+        log(index.find("dir0/unwatched.txt").has_value() && index.is_watching(), "refresh() rebuilds when not every directory is watched");
+      #endif
+    }
+
+    // Benchmark: Folder::find vs FolderIndex::find
+    {
+      TempFolder tree;
+      for (int i : range(500))
+        std::ofstream(tree / ("f" + i2s(i))) << i;
+      FolderIndex index(tree);
+      bm.reset();
+      for (int i : range(5'000))
+        do_not_optimize(tree.find("f" + i2s(i % 500)));
+      double folderMs = bm.elapsed_ms();
+      bm.reset();
+      for (int i : range(5'000))
+        do_not_optimize(index.find("f" + i2s(i % 500)));
+      double indexMs = bm.elapsed_ms();
+      std::cout << "  Folder::find: " << folderMs << "ms, FolderIndex::find: " << indexMs << "ms (5'000 lookups)\n";
+      log(indexMs < folderMs, "FolderIndex::find avoids the filesystem");
+    }
+
     // Cleanup
     stdfs::remove_all(tempDir);
   }
@@ -1234,6 +2061,285 @@ int main() {
 
 
 
+  #ifndef _WIN32
+  title("Testing/Benchmarking cslib::HttpClient"); {
+
+    // Local stand-in server, one thread per connection, answers pipelined requests in order
+    struct LoopbackServer {
+      int listenFd = -1;
+      uint16_t port = 0;
+      std::atomic<size_t> accepted = 0;
+      std::mutex lock;
+      std::vector<int> clients;
+      std::vector<std::thread> threads;
+      std::thread acceptor;
+
+      LoopbackServer() {
+        listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        ::bind(listenFd, reinterpret_cast<sockaddr*>(&address), length);
+        ::listen(listenFd, 128);
+        ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+        port = ntohs(address.sin_port);
+        acceptor = std::thread([this] {
+          while (true) {
+            const int client = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client == -1)
+              return;
+            ++accepted;
+            const int noDelay = 1;
+            ::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            std::lock_guard guard(lock);
+            clients.push_back(client);
+            threads.emplace_back([this, client] { serve(client); });
+          }
+        });
+      }
+      ~LoopbackServer() {
+        ::shutdown(listenFd, SHUT_RDWR);
+        acceptor.join();
+        for (int client : clients)
+          ::shutdown(client, SHUT_RDWR);
+        for (std::thread& thread : threads)
+          thread.join();
+        for (int client : clients)
+          ::close(client);
+        ::close(listenFd);
+      }
+      str_t url(strv_t path) const {
+        return "http://127.0.0.1:" + std::to_string(port) + str_t(path);
+      }
+      static void send_all(int fd, strv_t data) {
+        while (!data.empty()) {
+          const ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+          if (sent <= 0)
+            return;
+          data.remove_prefix(size_t(sent));
+        }
+      }
+      static str_t with_length(strv_t status, strv_t body) {
+        return "HTTP/1.1 " + str_t(status) + "\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + str_t(body);
+      }
+      void serve(int fd) {
+        str_t pending;
+        std::array<char, 4096> chunk;
+        while (true) {
+          size_t headEnd;
+          while ((headEnd = pending.find("\r\n\r\n")) == str_t::npos) {
+            const ssize_t got = ::recv(fd, chunk.data(), chunk.size(), 0);
+            if (got <= 0)
+              return;
+            pending.append(chunk.data(), size_t(got));
+            if (!pending.starts_with(strv_t("GET ").substr(0, std::min<size_t>(pending.size(), 4)))) {
+              ::shutdown(fd, SHUT_RDWR); // Not HTTP (like a TLS handshake), hang up
+              return;
+            }
+          }
+          str_t path = pending.substr(4, pending.find(' ', 4) - 4);
+          pending.erase(0, headEnd + 4);
+          if (path.starts_with("http://")) // Asked as a proxy
+            path.erase(0, path.find('/', 7));
+          if (path == "/hello")
+            send_all(fd, with_length("200 OK", "hello"));
+          else if (path.starts_with("/echo/"))
+            send_all(fd, with_length("200 OK", path.substr(6)));
+          else if (path == "/chunked")
+            send_all(fd, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\nX-Test: yes\r\n\r\n4\r\nWiki\r\n5\r\npedia\r\n0\r\nX-Trailer: 1\r\n\r\n");
+          else if (path == "/redirect")
+            send_all(fd, "HTTP/1.1 302 Found\r\nLocation: /hello\r\nContent-Length: 0\r\n\r\n");
+          else if (path == "/continue")
+            send_all(fd, "HTTP/1.1 100 Continue\r\n\r\n" + with_length("200 OK", "ok"));
+          else if (path == "/big")
+            send_all(fd, with_length("200 OK", str_t(1 << 20, 'x')));
+          else if (path == "/to-https")
+            send_all(fd, "HTTP/1.1 301 Moved Permanently\r\nLocation: https://127.0.0.1:" + std::to_string(port) + "/hello\r\nContent-Length: 0\r\n\r\n");
+          else if (path.starts_with("/once/")) { // Closes after one response without saying so
+            send_all(fd, with_length("200 OK", path.substr(6)));
+            ::shutdown(fd, SHUT_WR);
+            return;
+          }
+          else if (path == "/close") {
+            send_all(fd, "HTTP/1.0 200 OK\r\n\r\nuntil close");
+            ::shutdown(fd, SHUT_WR);
+            return;
+          }
+          else
+            send_all(fd, with_length("404 Not Found", "not found"));
+        }
+      }
+    };
+    LoopbackServer server;
+
+    // get() uses the in-process client for http://
+    {
+      log(get(server.url("/hello")).value_or("") == "hello", "get() should fetch from the loopback server");
+      log(get(server.url("/chunked")).value_or("") == "Wikipedia", "Chunked bodies should be decoded");
+      log(get(server.url("/redirect")).value_or("") == "hello", "Redirects should be followed");
+      log(get(server.url("/continue")).value_or("") == "ok", "Interim 1xx responses should be skipped");
+      log(get(server.url("/close")).value_or("") == "until close", "Bodies ending with the connection should be read");
+      log(get(server.url("/big")).value_or("").size() == 1 << 20, "Large bodies should arrive in full");
+      log(get(server.url("/missing")).error() == 22 << 8, "HTTP errors should be reported like curl -f");
+      log(!get("http://127.0.0.1:1/"), "Refused connections should be reported");
+      HttpClient::result_t away = HttpClient::shared().fetch(server.url("/to-https"));
+      log(away && away->status == 301, "Redirects to https:// should be handed back instead of followed");
+      log(get(server.url("/to-https")).error() == 35 << 8, "get() should let curl follow redirects to https:// (TLS fails against this server)");
+      ::setenv("http_proxy", server.url("").c_str(), 1);
+      log(get("http://proxied.invalid/hello").value_or("") == "hello", "get() should leave proxied requests to curl");
+      ::unsetenv("http_proxy");
+    }
+
+    // Servers closing kept-alive connections after any response
+    {
+      HttpClient client;
+      client.pipelineDepth = 4;
+      std::vector<str_t> urls;
+      for (size_t i = 0; i < 8; ++i)
+        urls.push_back(server.url("/once/" + std::to_string(i)));
+      std::vector<HttpClient::result_t> results = client.fetch_all(urls, 2);
+      bool allOk = true;
+      for (size_t i = 0; i < urls.size(); ++i)
+        allOk = allOk && results.at(i) && results.at(i)->body == std::to_string(i);
+      log(allOk, "Unanswered pipelined requests should be retried on a new connection");
+    }
+
+    // Every address of a host is tried in turn
+    {
+      HttpClient client;
+      const HttpUrl url = *HttpUrl::parse(server.url("/hello"));
+      HttpClient::address_t refused{}, listening{};
+      sockaddr_in6 v6{};
+      v6.sin6_family = AF_INET6;
+      v6.sin6_addr = in6addr_loopback;
+      v6.sin6_port = htons(server.port);
+      std::memcpy(&refused.first, &v6, sizeof(v6));
+      refused.second = sizeof(v6);
+      sockaddr_in v4{};
+      v4.sin_family = AF_INET;
+      v4.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      v4.sin_port = htons(server.port);
+      std::memcpy(&listening.first, &v4, sizeof(v4));
+      listening.second = sizeof(v4);
+      client.resolved[url.key()] = HttpClient::Resolved{{refused, listening}, std::chrono::steady_clock::now() + std::chrono::hours(1)};
+      HttpClient::result_t response = client.fetch(server.url("/hello"));
+      log(response && response->body == "hello", "HttpClient should fall back to the next address (::1 -> 127.0.0.1)");
+    }
+
+    // Response details
+    {
+      HttpClient client;
+      HttpClient::result_t response = client.fetch(server.url("/chunked"));
+      log(response && response->status == 200 && response->reason == "OK", "Status and reason should be parsed");
+      log(response && response->header("x-test") == "yes" && response->header("X-TEST") == "yes", "Header lookup should ignore case");
+      response = client.fetch(server.url("/missing"));
+      log(response && response->status == 404 && response->body == "not found", "HttpClient should hand out error responses too");
+      log(!client.fetch("https://127.0.0.1/"), "https:// should be refused by HttpClient");
+      log(!HttpUrl::parse("http://user@host/") && HttpUrl::parse("http://[::1]:8080/x")->host == "::1", "HttpUrl should parse only what it supports");
+    }
+
+    // parse_response resumes where it stopped
+    {
+      const str_t raw = "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                        "4\r\nWiki\r\n5\r\npedia\r\n0\r\nX-Trailer: 1\r\n\r\nHTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nhi";
+      HttpClient::ResponseParser parser;
+      std::optional<size_t> used;
+      size_t fedBytes = 0;
+      while (!used && fedBytes < raw.size())
+        used = HttpClient::parse_response(strv_t(raw).substr(0, ++fedBytes), false, parser);
+      log(used == raw.find("HTTP/1.1 200 OK\r\nContent-Length") && parser.response.body == "Wikipedia" && parser.keepAlive,
+        "parse_response fed byte by byte ends exactly after the chunked response");
+      const strv_t rest = strv_t(raw).substr(*used);
+      parser = {};
+      used.reset();
+      for (size_t fed = 1; !used && fed <= rest.size(); ++fed)
+        used = HttpClient::parse_response(rest.substr(0, fed), false, parser);
+      log(used == rest.size() && parser.response.body == "hi", "parse_response fed byte by byte handles Content-Length");
+
+      // A large chunked body arriving in pieces is parsed in linear time
+      str_t big = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+      const str_t piece(256, 'c');
+      for ([[maybe_unused]] int _ : range(64 * 1024))
+        big += "100\r\n" + piece + "\r\n";
+      big += "0\r\n\r\n";
+      bm.reset();
+      parser = {};
+      used = HttpClient::parse_response(big, false, parser);
+      double oneShotMs = bm.elapsed_ms();
+      const bool oneShotOk = used == big.size() && parser.response.body.size() == 64 * 1024 * 256;
+      bm.reset();
+      parser = {};
+      used.reset();
+      for (size_t fed = 0; !used && fed < big.size();) {
+        fed = std::min(big.size(), fed + 64 * 1024);
+        used = HttpClient::parse_response(strv_t(big).substr(0, fed), false, parser);
+      }
+      double piecewiseMs = bm.elapsed_ms();
+      std::cout << "  16MB chunked body: " << oneShotMs << "ms at once, " << piecewiseMs << "ms in 64KB pieces\n";
+      log(oneShotOk && used == big.size() && parser.response.body.size() == 64 * 1024 * 256, "parse_response decodes a large chunked body in pieces");
+      log(piecewiseMs < 5 * oneShotMs + 20, "parse_response doesn't re-parse from the start for every piece");
+    }
+
+    // Keep-alive reuses one connection
+    {
+      HttpClient client;
+      const size_t before = server.accepted;
+      bool allOk = true;
+      for (size_t i = 0; i < 50; ++i) {
+        const HttpClient::result_t response = client.fetch(server.url("/hello"));
+        allOk = allOk && response && response->body == "hello";
+      }
+      log(allOk, "Sequential fetches should all succeed");
+      log(server.accepted - before == 1, "Sequential fetches should share one kept-alive connection");
+    }
+
+    // Batches over a bounded set of connections, with and without pipelining
+    for (size_t depth : {1, 8}) {
+      HttpClient client;
+      client.pipelineDepth = depth;
+      std::vector<str_t> urls;
+      for (size_t i = 0; i < 500; ++i)
+        urls.push_back(server.url("/echo/" + std::to_string(i)));
+      urls.push_back(server.url("/redirect"));
+      const size_t before = server.accepted;
+      std::vector<HttpClient::result_t> results = client.fetch_all(urls, 4);
+      bool inOrder = results.back() && results.back()->body == "hello";
+      for (size_t i = 0; i < 500; ++i)
+        inOrder = inOrder && results.at(i) && results.at(i)->body == std::to_string(i);
+      str_t message = "fetch_all should return every response in order (pipelineDepth " + std::to_string(depth) + ")";
+      log(inOrder, message);
+      log(server.accepted - before <= 4, "fetch_all should not open more than maxConnections");
+    }
+
+    // curl per request vs in-process client
+    {
+      constexpr size_t REQUESTS = 200;
+      std::vector<str_t> urls;
+      for (size_t i = 0; i < REQUESTS; ++i)
+        urls.push_back(server.url("/echo/" + std::to_string(i)));
+      bm.reset();
+      for (const str_t& url : urls)
+        sh_call("curl -fsSL " + url);
+      const double curlMs = bm.elapsed_ms();
+      HttpClient client;
+      bm.reset();
+      for (const str_t& url : urls)
+        client.fetch(url);
+      const double keepAliveMs = bm.elapsed_ms();
+      client.pipelineDepth = 8;
+      bm.reset();
+      client.fetch_all(urls, 4);
+      const double batchMs = bm.elapsed_ms();
+      std::cout << "  curl x" << REQUESTS << ": " << curlMs << "ms\n";
+      std::cout << "  HttpClient::fetch x" << REQUESTS << " (keep-alive): " << keepAliveMs << "ms\n";
+      std::cout << "  HttpClient::fetch_all x" << REQUESTS << " (4 connections, pipelined): " << batchMs << "ms\n";
+    }
+  }
+  #endif
+
+
+
   title("Extensive tests for to_number() template function"); {
 
     static_assert(to_number<int>(42L) == 42, "long to int conversion within range");
@@ -1394,6 +2500,190 @@ int main() {
 
 
 
+  title("Testing/Benchmarking cslib::ThreadPool"); {
+
+    // Basic submission
+    {
+      ThreadPool pool(2);
+      std::future<int> fut = pool.submit([](int x, int y){ return x * y; }, 6, 7);
+      log(pool.get(fut) == 42, "submit() returns the task's result");
+      log(pool.size() == 2, "size() matches the configured worker count");
+    }
+
+    // Exceptions propagate through the future
+    {
+      ThreadPool pool(1);
+      std::future<void> fut = pool.submit([]{ throw std::runtime_error("pool fail"); });
+      maybe<void> res = caught([&]{ fut.get(); });
+      log(!res.has_value(), "Exception thrown in pooled task propagates");
+    }
+
+    // Nested submission on a single worker must not deadlock
+    {
+      ThreadPool pool(1);
+      std::future<int> outer = pool.submit([&pool] {
+        std::future<int> inner = pool.submit([]{ return 21; });
+        return pool.get(inner) * 2;
+      });
+      log(pool.get(outer) == 42, "Nested submission on a one-worker pool completes");
+    }
+
+    // Destructor drains outstanding work
+    {
+      std::atomic<int> done = 0;
+      {
+        ThreadPool pool(2);
+        for ([[maybe_unused]] int _ : range(100))
+          (void)pool.submit([&done]{ ++done; });
+      }
+      log(done == 100, "Destructor runs every queued task before joining");
+    }
+
+    // do_in_parallel opt-in path
+    {
+      std::future<int> fut = do_in_parallel(ThreadPool::shared(), [](int x){ return x + 1; }, 41);
+      log(fut.get() == 42, "do_in_parallel(pool, ...) runs on the pool");
+    }
+
+    // parallel_for / parallel_map / parallel_reduce
+    {
+      std::atomic<long> sum = 0;
+      parallel_for(range(1'000), [&sum](int i){ sum += i; });
+      log(sum == 499'500, "parallel_for visits every element of range(1'000)");
+
+      std::vector<int> squares = parallel_map(range(100), [](int i){ return i * i; });
+      bool good = squares.size() == 100;
+      for (int i : range(100))
+        good = good && squares.at(i) == i * i;
+      log(good, "parallel_map keeps order and size");
+
+      log(parallel_reduce(range(1'000), 0L, std::plus<>()) == 499'500, "parallel_reduce sums range(1'000)");
+      log(parallel_reduce(std::vector<int>{}, 7, std::plus<>()) == 7, "parallel_reduce on empty range returns init");
+      log(parallel_reduce(range(1'000), 0L, std::plus<>(), [](int x) { return long(x) * x; }) == 332'833'500, "parallel_reduce with transform sums squares");
+      log(parallel_reduce(range(1'000), 10L, std::plus<>(), [](int x) { return long(x); }) == 499'510, "parallel_reduce with transform adds init once");
+      log(parallel_map(std::vector<int>{}, [](int i){ return i; }).empty(), "parallel_map on empty range returns empty vector");
+
+      std::atomic<int> nested = 0;
+      parallel_for(range(8), [&nested](int){
+        parallel_for(range(8), [&nested](int){ ++nested; });
+      });
+      log(nested == 64, "Nested parallel_for completes without deadlock");
+
+      maybe<void> res = caught([]{ parallel_for(range(10), [](int i){ if (i == 5) throw std::runtime_error("chunk"); }); });
+      log(!res.has_value(), "parallel_for rethrows exceptions from chunks");
+    }
+
+    // Benchmark: many tiny tasks via std::async vs the shared pool
+    {
+      constexpr int TASKS = 2'000;
+      std::atomic<int> counter = 0;
+      bm.reset();
+      {
+        std::vector<std::future<void>> futures;
+        for ([[maybe_unused]] int _ : range(TASKS))
+          futures.emplace_back(do_in_parallel([&counter]{ ++counter; }));
+        for (std::future<void>& fut : futures)
+          fut.get();
+      }
+      double asyncMs = bm.elapsed_ms();
+      bm.reset();
+      {
+        std::vector<std::future<void>> futures;
+        for ([[maybe_unused]] int _ : range(TASKS))
+          futures.emplace_back(do_in_parallel(ThreadPool::shared(), [&counter]{ ++counter; }));
+        for (std::future<void>& fut : futures)
+          fut.get();
+      }
+      double poolMs = bm.elapsed_ms();
+      std::cout << "  std::async: " << asyncMs << "ms, ThreadPool: " << poolMs << "ms (" << TASKS << " tasks)\n";
+      log(counter == 2 * TASKS, "Every benchmarked task ran");
+      log(poolMs < asyncMs, "ThreadPool beats std::async for many tiny tasks");
+    }
+  }
+
+
+
+  title("Testing cslib::BenchmarkSuite"); {
+    BenchmarkSuite suite;
+    suite.samples = 11;
+    suite.warmupMs = 1;
+    suite.usePerfCounters = true;
+
+    // Statistics are consistent
+    {
+      const BenchmarkStats& stats = suite.measure("pause(1)", [] { pause(1); });
+      log(stats.samples == 11 && stats.iterations >= 1, "measure() takes the configured amount of samples");
+      log(stats.minNs <= stats.medianNs && stats.medianNs <= stats.p99Ns && stats.p99Ns <= stats.maxNs, "min <= median <= p99 <= max");
+      log(stats.medianNs >= 1'000'000, "pause(1) measures at least 1ms per iteration");
+      log(stats.stddevNs >= 0 && stats.cycles.has_value(), "stddev and cycle count are reported");
+    }
+
+    // Calibration gives cheap functions many iterations
+    {
+      int x = 0;
+      const BenchmarkStats& stats = suite.measure("increment", [&x] { do_not_optimize(++x); });
+      log(stats.iterations > 1'000, "Cheap functions get calibrated to many iterations per sample");
+      log(stats.medianNs < 1'000, "Cheap functions measure in nanoseconds");
+    }
+
+    // Reports
+    {
+      str_t json = suite.to_json();
+      str_t csv = suite.to_csv();
+      log(json.starts_with("[\n") && json.find("\"name\": \"increment\"") != str_t::npos && json.find("\"median_ns\"") != str_t::npos, "to_json() lists every result");
+      log(separate(csv, "\n").size() == 4 && csv.starts_with("name,samples,iterations,min_ns,median_ns"), "to_csv() has a header and one row per result");
+      maybe<void> printed = caught([&] { suite.print(std::cout); });
+      log(printed.has_value(), "print() reports the results");
+      std::ostringstream report;
+      report << "HEADER\n" << std::setprecision(3);
+      suite.print(report);
+      report << "AFTER\n" << 1.23456;
+      const str_t text = report.str();
+      log(text.starts_with("HEADER\n  ") && text.contains("increment") && text.ends_with("\nAFTER\n1.23"), "print() appends to seekable streams and restores their formatting");
+      maybe<BenchmarkStats> noSamples = caught([] { BenchmarkSuite empty; empty.samples = 0; return empty.measure("x", []{}); });
+      log(!noSamples.has_value(), "measure() rejects 0 samples");
+    }
+  }
+
+
+
+  title("Benchmarking cslib hot functions"); {
+    BenchmarkSuite suite;
+    suite.samples = 15;
+    suite.usePerfCounters = true;
+
+    TempFolder dir;
+    for (int i : range(200))
+      std::ofstream(dir / ("entry_" + i2s(i) + ".txt")) << i;
+    str_t csvLine = to_str("id,name,value,comment,", scramble_name(200), ",x,y,z");
+    str_t payload = scramble_name(64 * 1024);
+    TimeStamp now;
+
+    suite.measure("to_str(int, str, double)", [] { do_not_optimize(to_str(42, " is ", 3.14)); });
+    suite.measure("separate(csv line, \",\")", [&] { do_not_optimize(separate(csvLine, ",")); });
+    suite.measure("read_data(64KiB)", [&] {
+      std::istringstream in(payload);
+      do_not_optimize(read_data(in));
+    });
+    suite.measure("do_io(64KiB)", [&] {
+      std::istringstream in(payload);
+      std::ostringstream out;
+      do_io(in, out);
+      do_not_optimize(out);
+    });
+    suite.measure("Folder::list(200 entries)", [&] { do_not_optimize(dir.list()); });
+    suite.measure("TimeStamp::as_str", [&] { do_not_optimize(now.as_str()); });
+    suite.measure("scramble_name(64)", [] { do_not_optimize(scramble_name(64)); });
+    suite.samples = 5;
+    suite.measure("sh_call(\"true\")", [] { do_not_optimize(sh_call("true")); });
+
+    suite.print(std::cout);
+    std::ofstream("bench_output.txt") << suite.to_json() << '\n' << suite.to_csv();
+    log(suite.results.size() == 8, "Benchmarked every hot function (report in bench_output.txt)");
+  }
+
+
+
 
 
   if (failedTests != 0) {